@@ -0,0 +1,397 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "config/parser.h"
+#include "spline/spline.h"
+#include "string/string.h"
+#include "file/file.h"
+
+#define SPLINE_BENCH_PARSER_OPTION_GROUP        "spline-bench"
+#define SPLINE_BENCH_PARAMETER_MIN_KNOTS        "min-knots"
+#define SPLINE_BENCH_PARAMETER_MAX_KNOTS        "max-knots"
+#define SPLINE_BENCH_PARAMETER_SAMPLES          "samples"
+#define SPLINE_BENCH_PARAMETER_BATCH_TIME       "batch-time"
+#define SPLINE_BENCH_PARAMETER_MAX_TIME         "max-time"
+#define SPLINE_BENCH_PARAMETER_TYPE             "type"
+#define SPLINE_BENCH_PARAMETER_SEED             "seed"
+#define SPLINE_BENCH_PARAMETER_OUTPUT           "output"
+
+#define SPLINE_BENCH_NUM_LOCATIONS              65536
+#define SPLINE_BENCH_NUM_CLUSTERS               64
+#define SPLINE_BENCH_CLUSTER_WIDTH              8.0
+
+typedef enum {
+  spline_bench_pattern_sequential,
+  spline_bench_pattern_random,
+  spline_bench_pattern_clustered,
+} spline_bench_pattern_t;
+
+const char* spline_bench_patterns[] = {
+  "sequential",
+  "random",
+  "clustered",
+};
+
+typedef enum {
+  spline_bench_method_eval,
+  spline_bench_method_eval_bisect,
+  spline_bench_method_eval_linear,
+  spline_bench_method_eval_array,
+  spline_bench_method_int_y1,
+  spline_bench_method_int_y2,
+  spline_bench_method_int_y1_y2,
+  spline_bench_method_int_natural,
+  spline_bench_method_int_clamped,
+  spline_bench_method_int_periodic,
+  spline_bench_method_int_not_a_knot,
+} spline_bench_method_t;
+
+const char* spline_bench_methods[] = {
+  "spline_eval",
+  "spline_eval_bisect",
+  "spline_eval_linear",
+  "spline_eval_array",
+  "spline_int_y1",
+  "spline_int_y2",
+  "spline_int_y1_y2",
+  "spline_int_natural",
+  "spline_int_clamped",
+  "spline_int_periodic",
+  "spline_int_not_a_knot",
+};
+
+config_param_t spline_bench_default_options_params[] = {
+  {SPLINE_BENCH_PARAMETER_MIN_KNOTS,
+    config_param_type_int,
+    "10",
+    "[10, 1000000000]",
+    "The smallest number of spline knots to be benchmarked"},
+  {SPLINE_BENCH_PARAMETER_MAX_KNOTS,
+    config_param_type_int,
+    "10000000",
+    "[10, 1000000000]",
+    "The largest number of spline knots to be benchmarked, where the number "
+    "of knots increases by a factor of ten from the smallest number"},
+  {SPLINE_BENCH_PARAMETER_SAMPLES,
+    config_param_type_int,
+    "10000",
+    "[1, 1000000]",
+    "The number of individually timed operations per benchmark, from "
+    "which the latency percentiles are computed"},
+  {SPLINE_BENCH_PARAMETER_BATCH_TIME,
+    config_param_type_float,
+    "0.1",
+    "(0.0, inf)",
+    "The minimum duration of the timed batch of operations in [s], from "
+    "which the throughput of a benchmark is computed"},
+  {SPLINE_BENCH_PARAMETER_MAX_TIME,
+    config_param_type_float,
+    "1.0",
+    "(0.0, inf)",
+    "The maximum duration of the latency measurements of a benchmark in "
+    "[s], after which no further operations will be timed, possibly "
+    "reducing the number of samples"},
+  {SPLINE_BENCH_PARAMETER_TYPE,
+    config_param_type_enum,
+    "base",
+    "base|first|second",
+    "The type of spline evaluation benchmarked, where 'base' refers to "
+    "the base function, and 'first' or 'second' indicates the first or "
+    "second derivative, respectively"},
+  {SPLINE_BENCH_PARAMETER_SEED,
+    config_param_type_int,
+    "0",
+    "[0, 2147483647]",
+    "The seed of the pseudo-random generator of knots and locations"},
+  {SPLINE_BENCH_PARAMETER_OUTPUT,
+    config_param_type_string,
+    "-",
+    "",
+    "Write benchmark results to the specified output file or '-' for "
+    "stdout"},
+};
+
+const config_default_t spline_bench_default_options = {
+  spline_bench_default_options_params,
+  sizeof(spline_bench_default_options_params)/sizeof(config_param_t),
+};
+
+double spline_bench_clock(void) {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec+time.tv_nsec*1e-9;
+}
+
+int spline_bench_compare(const void* a, const void* b) {
+  double difference = *(const double*)a-*(const double*)b;
+  return (difference > 0.0) ? 1 : ((difference < 0.0) ? -1 : 0);
+}
+
+double spline_bench_percentile(const double* samples, size_t num_samples,
+    double percentile) {
+  size_t i = ceil(percentile*num_samples)-1;
+  return samples[(i < num_samples) ? i : num_samples-1];
+}
+
+void spline_bench_init_locations(double* x, size_t num_locations,
+    spline_bench_pattern_t pattern, const spline_t* spline) {
+  double x_min = spline->knots[0].x;
+  double x_max = spline->knots[spline->num_knots-1].x;
+  double width = SPLINE_BENCH_CLUSTER_WIDTH*(x_max-x_min)/
+    (spline->num_knots-1);
+  double x_c = x_min;
+  size_t i;
+
+  for (i = 0; i < num_locations; ++i) {
+    switch (pattern) {
+      case spline_bench_pattern_sequential:
+        x[i] = x_min+(i+0.5)*(x_max-x_min)/num_locations;
+        break;
+      case spline_bench_pattern_random:
+        x[i] = x_min+drand48()*(x_max-x_min);
+        break;
+      case spline_bench_pattern_clustered:
+        if (!(i % (num_locations/SPLINE_BENCH_NUM_CLUSTERS)))
+          x_c = x_min+drand48()*(x_max-x_min);
+        x[i] = x_c+(drand48()-0.5)*width;
+        if (x[i] < x_min)
+          x[i] = x_min;
+        if (x[i] > x_max)
+          x[i] = x_max;
+        break;
+    }
+  }
+}
+
+void spline_bench_run(spline_bench_method_t method, spline_t* spline,
+    spline_eval_type_t eval_type, const spline_point_t* points,
+    size_t num_points, const double* x, double* values, size_t* location,
+    size_t* index, size_t num_operations) {
+  size_t i, j = *location, num_locations;
+
+  switch (method) {
+    case spline_bench_method_eval:
+      for (i = 0; i < num_operations; ++i, j = (j+1) %
+          SPLINE_BENCH_NUM_LOCATIONS)
+        values[j] = spline_eval(spline, eval_type, x[j]);
+      break;
+    case spline_bench_method_eval_bisect:
+      for (i = 0; i < num_operations; ++i, j = (j+1) %
+          SPLINE_BENCH_NUM_LOCATIONS)
+        values[j] = spline_eval_bisect(spline, eval_type, x[j], 0,
+          spline->num_knots-1);
+      break;
+    case spline_bench_method_eval_linear:
+      for (i = 0; i < num_operations; ++i, j = (j+1) %
+          SPLINE_BENCH_NUM_LOCATIONS)
+        values[j] = spline_eval_linear(spline, eval_type, x[j], index);
+      break;
+    case spline_bench_method_eval_array:
+      for (i = 0; i < num_operations; i += num_locations, j = (j+
+          num_locations) % SPLINE_BENCH_NUM_LOCATIONS) {
+        num_locations = SPLINE_BENCH_NUM_LOCATIONS-j;
+        if (num_locations > num_operations-i)
+          num_locations = num_operations-i;
+        spline_eval_array(spline, eval_type, &x[j], &values[j],
+          num_locations);
+      }
+      break;
+    case spline_bench_method_int_y1:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_y1(spline, points, num_points, 0.0, 0.0);
+      break;
+    case spline_bench_method_int_y2:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_y2(spline, points, num_points, 0.0, 0.0);
+      break;
+    case spline_bench_method_int_y1_y2:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_y1_y2(spline, points, num_points, 0.0, 0.0, 0.0, 0.0,
+          0.5, 0.5);
+      break;
+    case spline_bench_method_int_natural:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_natural(spline, points, num_points);
+      break;
+    case spline_bench_method_int_clamped:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_clamped(spline, points, num_points);
+      break;
+    case spline_bench_method_int_periodic:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_periodic(spline, points, num_points);
+      break;
+    case spline_bench_method_int_not_a_knot:
+      for (i = 0; i < num_operations; ++i)
+        spline_int_not_a_knot(spline, points, num_points);
+      break;
+  }
+
+  *location = j;
+}
+
+int main(int argc, char **argv) {
+  config_parser_t parser;
+  spline_t spline;
+  file_t output_file;
+
+  config_parser_init_default(&parser, 0, 0,
+    "Benchmark cubic spline evaluation and interpolation",
+    "The command measures the throughput and latency percentiles of cubic "
+    "spline evaluation for sequential, random, and clustered locations, "
+    "and of cubic spline interpolation with all supported boundary "
+    "conditions, for increasing numbers of spline knots. The throughput "
+    "is obtained from a timed batch of operations, whereas the latencies "
+    "are obtained from individually timed operations, corrected by the "
+    "median overhead of reading the clock. The results are printed to a "
+    "file or stdout, one benchmark per line.");
+  config_parser_add_option_group(&parser, SPLINE_BENCH_PARSER_OPTION_GROUP,
+    &spline_bench_default_options, "Spline benchmark options",
+    "These options control the benchmarks performed by the command.");
+  config_parser_parse(&parser, argc, argv, config_parser_exit_error);
+
+  config_parser_option_group_t* spline_bench_option_group =
+    config_parser_get_option_group(&parser, SPLINE_BENCH_PARSER_OPTION_GROUP);
+  size_t min_knots = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MIN_KNOTS);
+  size_t max_knots = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MAX_KNOTS);
+  size_t num_samples = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_SAMPLES);
+  double batch_time = config_get_float(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_BATCH_TIME);
+  double max_time = config_get_float(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_MAX_TIME);
+  spline_eval_type_t eval_type = config_get_enum(
+    &spline_bench_option_group->options, SPLINE_BENCH_PARAMETER_TYPE);
+  int seed = config_get_int(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_SEED);
+  const char* output = config_get_string(&spline_bench_option_group->options,
+    SPLINE_BENCH_PARAMETER_OUTPUT);
+
+  file_init_name(&output_file, output);
+  if (string_equal(output, "-"))
+    file_open_stream(&output_file, stdout, file_mode_write);
+  else
+    file_open(&output_file, file_mode_write);
+  error_exit(&output_file.error);
+
+  file_printf(&output_file, "# %s %s %s %s %s %s %s %s %s %s\n",
+    "method", "pattern", "knots", "batch", "samples", "throughput[1/s]",
+    "p50[ns]", "p90[ns]", "p99[ns]", "max[ns]");
+  error_exit(&output_file.error);
+
+  double* samples = malloc(num_samples*sizeof(double));
+  double* x = malloc(SPLINE_BENCH_NUM_LOCATIONS*sizeof(double));
+  double* values = malloc(SPLINE_BENCH_NUM_LOCATIONS*sizeof(double));
+
+  size_t j;
+  for (j = 0; j < num_samples; ++j) {
+    double timestamp = spline_bench_clock();
+    samples[j] = spline_bench_clock()-timestamp;
+  }
+  qsort(samples, num_samples, sizeof(double), spline_bench_compare);
+  double overhead = spline_bench_percentile(samples, num_samples, 0.5);
+
+  srand48(seed);
+  spline_init(&spline);
+
+  size_t num_knots;
+  for (num_knots = min_knots; num_knots <= max_knots; num_knots *= 10) {
+    spline_point_t* points = malloc(num_knots*sizeof(spline_point_t));
+    double x_i = 0.0;
+    size_t i;
+
+    for (i = 0; i < num_knots; ++i) {
+      spline_point_init(&points[i], x_i, sin(0.1*x_i));
+      x_i += 0.5+drand48();
+    }
+
+    spline_int_natural(&spline, points, num_knots);
+    error_exit(&spline.error);
+    spline_eval(&spline, eval_type, points[0].x);
+
+    spline_bench_method_t method;
+    for (method = spline_bench_method_eval;
+        method <= spline_bench_method_int_not_a_knot; ++method) {
+      int eval = (method <= spline_bench_method_eval_array);
+      spline_bench_pattern_t pattern;
+
+      for (pattern = spline_bench_pattern_sequential;
+          pattern <= (eval ? spline_bench_pattern_clustered :
+            spline_bench_pattern_sequential); ++pattern) {
+        size_t location = 0, index = 0, batch = 1;
+        double timestamp, time;
+
+        spline_bench_init_locations(x, SPLINE_BENCH_NUM_LOCATIONS, pattern,
+          &spline);
+
+        while (1) {
+          timestamp = spline_bench_clock();
+          spline_bench_run(method, &spline, eval_type, points, num_knots,
+            x, values, &location, &index, batch);
+          if ((time = spline_bench_clock()-timestamp) >= batch_time)
+            break;
+          batch *= 2;
+        }
+
+        double start = spline_bench_clock();
+        for (j = 0; (j < num_samples) && (!j ||
+            (spline_bench_clock()-start < max_time)); ++j) {
+          timestamp = spline_bench_clock();
+          spline_bench_run(method, &spline, eval_type, points, num_knots,
+            x, values, &location, &index, 1);
+          samples[j] = spline_bench_clock()-timestamp-overhead;
+
+          samples[j] = (samples[j] > 0.0) ? 1e9*samples[j] : 0.0;
+        }
+        qsort(samples, j, sizeof(double), spline_bench_compare);
+
+        file_printf(&output_file,
+          "%s %s %lu %lu %lu %10lg %10lg %10lg %10lg %10lg\n",
+          spline_bench_methods[method], eval ?
+            spline_bench_patterns[pattern] : "-",
+          (unsigned long)num_knots, (unsigned long)batch, (unsigned long)j,
+          batch/time, spline_bench_percentile(samples, j, 0.5),
+          spline_bench_percentile(samples, j, 0.9),
+          spline_bench_percentile(samples, j, 0.99), samples[j-1]);
+        error_exit(&output_file.error);
+      }
+    }
+
+    free(points);
+  }
+
+  spline_destroy(&spline);
+  free(samples);
+  free(x);
+  free(values);
+
+  file_destroy(&output_file);
+  config_parser_destroy(&parser);
+
+  return 0;
+}
@@ -23,6 +23,7 @@
 
 #include "config/parser.h"
 #include "spline/spline.h"
+#include "spline/curve.h"
 #include "string/string.h"
 #include "file/file.h"
 
@@ -32,6 +33,8 @@
 #define SPLINE_EVAL_PARSER_OPTION_GROUP         "spline-eval"
 #define SPLINE_EVAL_PARAMETER_TYPE              "type"
 #define SPLINE_EVAL_PARAMETER_OUTPUT            "output"
+#define SPLINE_EVAL_PARAMETER_BINARY            "binary"
+#define SPLINE_EVAL_PARAMETER_ARC_LENGTH        "arc-length"
 
 config_param_t spline_eval_default_arguments_params[] = {
   {SPLINE_EVAL_PARAMETER_FILE,
@@ -60,6 +63,19 @@ config_param_t spline_eval_default_options_params[] = {
     "The type of spline evaluation requested, where 'base' refers to "
     "the base function, and 'first' or 'second' indicates the first or "
     "second derivative, respectively"},
+  {SPLINE_EVAL_PARAMETER_BINARY,
+    config_param_type_bool,
+    "false",
+    "false|true",
+    "Read the input spline from a binary file, which will be memory-mapped "
+    "unless it is read from stdin"},
+  {SPLINE_EVAL_PARAMETER_ARC_LENGTH,
+    config_param_type_bool,
+    "false",
+    "false|true",
+    "Generate locations at equidistant arc lengths of the spline function's "
+    "graph instead of equidistant locations, in which case the step size "
+    "refers to arc length"},
   {SPLINE_EVAL_PARAMETER_OUTPUT,
     config_param_type_string,
     "-",
@@ -75,14 +91,15 @@ const config_default_t spline_eval_default_options = {
 int main(int argc, char **argv) {
   config_parser_t parser;
   spline_t spline;
+  spline_curve_t curve;
   file_t output_file;
 
   config_parser_init_default(&parser, &spline_eval_default_arguments, 0,
     "Evaluate a cubic spline at equidistant locations",
     "The command evaluates a cubic input spline at equidistant "
-    "locations and prints the corresponding function values to a file "
-    "or stdout. Depending on the options provided, these values may be "
-    "generated from the base function or its derivatives.");
+    "locations or arc lengths and prints the corresponding function "
+    "values to a file or stdout. Depending on the options provided, these "
+    "values may be generated from the base function or its derivatives.");
   config_parser_add_option_group(&parser, SPLINE_EVAL_PARSER_OPTION_GROUP,
     &spline_eval_default_options, "Spline evaluation options",
     "These options control the spline evaluation performed by the command.");
@@ -99,10 +116,19 @@ int main(int argc, char **argv) {
     &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_TYPE);
   const char* output = config_get_string(
     &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_OUTPUT);
+  config_param_bool_t binary = config_get_bool(
+    &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_BINARY);
+  config_param_bool_t arc_length = config_get_bool(
+    &spline_eval_option_group->options, SPLINE_EVAL_PARAMETER_ARC_LENGTH);
 
   spline_init(&spline);
   
-  spline_read(file, &spline);
+  if (!binary)
+    spline_read(file, &spline);
+  else if (string_equal(file, "-"))
+    spline_read_binary(file, &spline);
+  else
+    spline_map(file, &spline, 1);
   error_exit(&spline.error);
 
   file_init_name(&output_file, output);
@@ -112,18 +138,29 @@ int main(int argc, char **argv) {
     file_open(&output_file, file_mode_write);
   error_exit(&output_file.error);
   
+  spline_curve_init(&curve, SPLINE_CURVE_GRAPH_CHANNELS);
+  if (arc_length) {
+    spline_curve_graph(&curve, &spline);
+    error_exit(&curve.error);
+  }
+  
   double x = spline.num_knots ? spline.knots[0].x : 0.0;
   double f_x;
   size_t i = 0, j = 0;
   
-  while (!isnan(f_x = spline_eval_linear(&spline, eval_type, x, &i))) {
+  while (!isnan(x) &&
+      !isnan(f_x = spline_eval_linear(&spline, eval_type, x, &i))) {
     file_printf(&output_file, "%10lg %10lg\n", x, f_x);
     error_exit(&output_file.error);
     
     ++j;
-    x = spline.knots[0].x+step_size*j;
+    if (arc_length)
+      x = spline_curve_find_length(&curve, step_size*j);
+    else
+      x = spline.knots[0].x+step_size*j;
   }
 
+  spline_curve_destroy(&curve);
   spline_destroy(&spline);
   file_destroy(&output_file);
   config_parser_destroy(&parser);
@@ -24,6 +24,7 @@
 #include "spline/spline.h"
 #include "string/string.h"
 #include "file/file.h"
+#include "file/reader.h"
 
 #define SPLINE_INT_PARAMETER_FILE             "FILE"
 
@@ -36,16 +37,8 @@
 #define SPLINE_INT_PARAMETER_Y2_N             "y2_n"
 #define SPLINE_INT_PARAMETER_R_0              "r_0"
 #define SPLINE_INT_PARAMETER_R_N              "r_n"
-
-typedef enum {
-  spline_type_y1,
-  spline_type_y2,
-  spline_type_y1_y2,
-  spline_type_natural,
-  spline_type_clamped,
-  spline_type_periodic,
-  spline_type_not_a_knot,
-} spline_type_t;
+#define SPLINE_INT_PARAMETER_THREADS          "threads"
+#define SPLINE_INT_PARAMETER_BINARY           "binary"
 
 config_param_t spline_int_default_arguments_params[] = {
   {SPLINE_INT_PARAMETER_FILE,
@@ -110,6 +103,19 @@ config_param_t spline_int_default_options_params[] = {
     "The ratio defining the relative location of the last intermediate knot "
     "in the original last spline segment with respect to the last knot if "
     "the requested spline type is 'y1-y2'"},
+  {SPLINE_INT_PARAMETER_THREADS,
+    config_param_type_int,
+    "1",
+    "[1, 64]",
+    "The maximum number of threads used for solving the interpolation "
+    "problem, which will only be partitioned for very large numbers of "
+    "data points"},
+  {SPLINE_INT_PARAMETER_BINARY,
+    config_param_type_bool,
+    "false",
+    "false|true",
+    "Write the interpolating spline and its segment coefficients to a "
+    "binary file"},
   {SPLINE_INT_PARAMETER_OUTPUT,
     config_param_type_string,
     "-",
@@ -144,7 +150,7 @@ int main(int argc, char **argv) {
   
   config_parser_option_group_t* spline_int_option_group =
     config_parser_get_option_group(&parser, SPLINE_INT_PARSER_OPTION_GROUP);
-  spline_type_t type = config_get_enum(&spline_int_option_group->options,
+  spline_int_type_t type = config_get_enum(&spline_int_option_group->options,
     SPLINE_INT_PARAMETER_TYPE);
   double y1_0 = config_get_float(&spline_int_option_group->options,
     SPLINE_INT_PARAMETER_Y1_0);
@@ -158,6 +164,10 @@ int main(int argc, char **argv) {
     SPLINE_INT_PARAMETER_R_0);
   double r_n = config_get_float(&spline_int_option_group->options,
     SPLINE_INT_PARAMETER_R_N);
+  int threads = config_get_int(&spline_int_option_group->options,
+    SPLINE_INT_PARAMETER_THREADS);
+  config_param_bool_t binary = config_get_bool(
+    &spline_int_option_group->options, SPLINE_INT_PARAMETER_BINARY);
   const char* output = config_get_string(&spline_int_option_group->options,
     SPLINE_INT_PARAMETER_OUTPUT);
   
@@ -168,51 +178,59 @@ int main(int argc, char **argv) {
     file_open(&input_file, file_mode_read);
   error_exit(&input_file.error);
 
-  char* line = 0;
+  file_reader_t input_reader;
+  file_reader_init(&input_reader, &input_file, 0);
+  
+  char* line;
   spline_point_t* points = 0;
-  size_t num_points = 0;
+  size_t num_points = 0, max_points = 0;
   
-  while (!file_eof(&input_file) &&
-      (file_read_line(&input_file, &line, 128) >= 0)) {
+  while (!file_reader_eof(&input_reader) &&
+      (file_reader_read_line(&input_reader, &line) >= 0)) {
     if (string_empty(line) || string_starts_with(line, "#"))
       continue;
     
     double x, y;
-    if (string_scanf(line, "%lg %lg\n", &x, &y) == 2) {
-      if (!(num_points % 64))
-        points = realloc(points, (num_points+64)*sizeof(spline_point_t));
+    size_t n_x;
+    if ((n_x = string_parse_float(line, &x)) &&
+        string_parse_float(&line[n_x], &y)) {
+      if (num_points == max_points) {
+        max_points = max_points ? 2*max_points : 64;
+        points = realloc(points, max_points*sizeof(spline_point_t));
+      }
       spline_point_init(&points[num_points], x, y);
       
       ++num_points;
     }
   }
-  string_destroy(&line);
+  file_reader_destroy(&input_reader);
   error_exit(&input_file.error);
   file_destroy(&input_file);
   
   spline_init(&spline);
+  spline.workspace.num_threads = threads;
   
   switch (type) {
-    case spline_type_y1:
+    case spline_int_type_y1:
       spline_int_y1(&spline, points, num_points, y1_0, y1_n);
       break;
-    case spline_type_y2:
+    case spline_int_type_y2:
       spline_int_y2(&spline, points, num_points, y2_0, y2_n);
       break;
-    case spline_type_y1_y2:
+    case spline_int_type_y1_y2:
       spline_int_y1_y2(&spline, points, num_points, y1_0, y1_n,
         y2_0, y2_n, r_0, r_n);
       break;
-    case spline_type_natural:
+    case spline_int_type_natural:
       spline_int_natural(&spline, points, num_points);
       break;
-    case spline_type_clamped:
+    case spline_int_type_clamped:
       spline_int_clamped(&spline, points, num_points);
       break;
-    case spline_type_periodic:
+    case spline_int_type_periodic:
       spline_int_periodic(&spline, points, num_points);
       break;
-    case spline_type_not_a_knot:
+    case spline_int_type_not_a_knot:
       spline_int_not_a_knot(&spline, points, num_points);
       break;
   }
@@ -221,7 +239,10 @@ int main(int argc, char **argv) {
   if (points)
     free(points);
   
-  spline_write(output, &spline);
+  if (binary)
+    spline_write_binary(output, &spline, 1);
+  else
+    spline_write(output, &spline);
   error_exit(&spline.error);
   
   spline_destroy(&spline);
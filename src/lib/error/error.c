@@ -20,26 +20,33 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdarg.h>
 #include <execinfo.h>
 
 #include "error.h"
 
-#include "string/string.h"
+#include "error/stats.h"
 
 int error_debug = 0;
+int error_where = 1;
 
-void error_set_where(error_t* error, size_t frame);
-void error_print_trace(FILE* stream, const error_t* error);
+__thread error_record_t error_last = {0, 0, 0, ""};
+
+void error_set_where(error_t* error, void* where);
+void error_set_last(const error_t* error);
+void error_set_blame(error_t* error, const error_t* blame);
+void error_print_trace(FILE* stream, int code, const char** descriptions,
+  void* where, const char* what);
 
 void error_init(error_t* error, const char** descriptions) {
   error->code = 0;
   error->descriptions = descriptions;
 
   error->where = 0;
-  error->what = 0;
+  error->what[0] = 0;
 
-  error->blame = 0;
+  error->num_blames = 0;
 }
 
 void error_init_copy(error_t* error, const error_t* src_error) {
@@ -52,63 +59,90 @@ void error_destroy(error_t* error) {
 }
 
 void error_copy(error_t* dst, const error_t* src) {
-  error_clear(dst);
-
+  size_t i;
+  
+  if (dst == src)
+    return;
+  
   dst->code = src->code;
   dst->descriptions = src->descriptions;
   
-  string_init_copy(&dst->where, src->where);
-  string_init_copy(&dst->what, src->what);
+  dst->where = src->where;
+  strcpy(dst->what, src->what);
   
-  if (src->blame) {
-    dst->blame = malloc(sizeof(error_t));
-    error_init_copy(dst->blame, src->blame);
-  }
+  for (i = 0; i < src->num_blames; ++i)
+    dst->blame[i] = src->blame[i];
+  dst->num_blames = src->num_blames;
 }
 
 void error_set(error_t* error, int code) {
   error_clear(error);
   
   error->code = code;
-  error_set_where(error, 1);
+  error_set_where(error, __builtin_return_address(0));
+  
+  error_set_last(error);
 }
 
-void error_set_where(error_t* error, size_t frame) {
-  void* frames[frame+2];
-  size_t num_frames = backtrace(frames, frame+2);
-  
-  char** symbols = 0;
-  if ((frame+1 < num_frames) &&
-      (symbols = backtrace_symbols(&frames[frame+1], 1))) {
-    string_copy(&error->where, symbols[0]);
-    free(symbols);
+void error_set_where(error_t* error, void* where) {
+#ifdef ERROR_NO_WHERE
+  error->where = 0;
+#else
+  error->where = error_where ? where : 0;
+#endif
+}
+
+void error_set_last(const error_t* error) {
+  if (error->code) {
+    error_last.code = error->code;
+    error_last.descriptions = error->descriptions;
+    error_last.where = error->where;
+    strcpy(error_last.what, error->what);
+    
+    if (error_stats)
+      error_stats_add(error);
   }
-  else
-    string_destroy(&error->where);
+}
+
+void error_set_blame(error_t* error, const error_t* blame) {
+  size_t i;
+  
+  if (!blame || (blame == error))
+    return;
+  
+  error->blame[0].code = blame->code;
+  error->blame[0].descriptions = blame->descriptions;
+  error->blame[0].where = blame->where;
+  strcpy(error->blame[0].what, blame->what);
+  
+  for (i = 0; (i < blame->num_blames) && (i+1 < ERROR_MAX_BLAMES); ++i)
+    error->blame[i+1] = blame->blame[i];
+  error->num_blames = i+1;
 }
 
 void error_blame(error_t* error, const error_t* blame, int code) {
   error_clear(error);
 
   error->code = code;
-  error_set_where(error, 1);
+  error_set_where(error, __builtin_return_address(0));
   
-  if (blame) {
-    error->blame = malloc(sizeof(error_t));
-    error_init_copy(error->blame, blame);
-  }
+  error_set_blame(error, blame);
+  
+  error_set_last(error);
 }
 
 void error_setf(error_t* error, int code, const char* format, ...) {
   error_clear(error);
 
   error->code = code;
-  error_set_where(error, 1);
+  error_set_where(error, __builtin_return_address(0));
   
   va_list vargs;  
   va_start(vargs, format);
-  string_vprintf(&error->what, format, vargs);
+  vsnprintf(error->what, sizeof(error->what), format, vargs);
   va_end(vargs);
+  
+  error_set_last(error);
 }
 
 void error_blamef(error_t* error, const error_t* blame, int code, const
@@ -116,23 +150,34 @@ void error_blamef(error_t* error, const error_t* blame, int code, const
   error_clear(error);
 
   error->code = code;
-  error_set_where(error, 1);
+  error_set_where(error, __builtin_return_address(0));
   
   va_list vargs;
   va_start(vargs, format);  
-  string_vprintf(&error->what, format, vargs);
+  vsnprintf(error->what, sizeof(error->what), format, vargs);
   va_end(vargs);
   
-  if (blame) {
-    error->blame = malloc(sizeof(error_t));
-    error_init_copy(error->blame, blame);
-  }
+  error_set_blame(error, blame);
+  
+  error_set_last(error);
 }
 
 int error_get(const error_t* error) {
   return error->code;
 }
 
+int error_get_last(error_record_t* record) {
+  *record = error_last;
+  return record->code;
+}
+
+void error_clear_last(void) {
+  error_last.code = 0;
+  error_last.descriptions = 0;
+  error_last.where = 0;
+  error_last.what[0] = 0;
+}
+
 const char* error_get_description(const error_t* error) {
   return error->descriptions[error->code];
 }
@@ -140,40 +185,45 @@ const char* error_get_description(const error_t* error) {
 void error_clear(error_t* error) {
   error->code = 0;
   
-  string_destroy(&error->where);
-  string_destroy(&error->what);
+  error->where = 0;
+  error->what[0] = 0;
   
-  if (error->blame) {
-    error_destroy(error->blame);
-
-    free(error->blame);
-    error->blame = 0;
-  }
+  error->num_blames = 0;
 }
 
 void error_print(FILE* stream, const error_t* error) {
+  size_t i;
+  
   fprintf(stream, "Error: %s%s%s", 
     error->descriptions[error->code],
-    !string_empty(error->what) ? ": " : "",
-    !string_empty(error->what) ? error->what : "");
+    error->what[0] ? ": " : "",
+    error->what);
   
   if (error_debug) {
     fprintf(stream, "\n");
-    error_print_trace(stream, error);
+    error_print_trace(stream, error->code, error->descriptions,
+      error->where, error->what);
+    
+    for (i = 0; i < error->num_blames; ++i) {
+      fprintf(stream, "\n");
+      error_print_trace(stream, error->blame[i].code,
+        error->blame[i].descriptions, error->blame[i].where,
+        error->blame[i].what);
+    }
   }
 }
 
-void error_print_trace(FILE* stream, const error_t* error) {
-  fprintf(stream, "  from %s: %s%s%s", 
-    !string_empty(error->where) ? error->where : "",
-    error->descriptions[error->code],
-    !string_empty(error->what) ? ": " : "",
-    !string_empty(error->what) ? error->what : "");
+void error_print_trace(FILE* stream, int code, const char** descriptions,
+    void* where, const char* what) {
+  char** symbols = where ? backtrace_symbols(&where, 1) : 0;
   
-  if (error->blame) {
-    fprintf(stream, "\n");
-    error_print_trace(stream, error->blame);
-  }
+  fprintf(stream, "  from %s: %s%s%s", 
+    symbols ? symbols[0] : "",
+    descriptions[code],
+    what[0] ? ": " : "",
+    what);
+  if (symbols)
+    free(symbols);
 }
 
 void error_exit(const error_t* error) {
@@ -41,16 +41,44 @@
 
 #include <stdio.h>
 
+/** \brief Predefined maximum length of an error explanation
+  */
+#define ERROR_WHAT_LENGTH                   128
+
+/** \brief Predefined maximum number of blamed errors
+  */
+#define ERROR_MAX_BLAMES                    4
+
+/** \brief Error record structure
+  * 
+  * An error record holds the code, location, and explanation of a blamed
+  * error by value.
+  */
+typedef struct error_record_t {
+  int code;                       //!< The error code.
+  const char** descriptions;      //!< The error descriptions.
+  
+  void* where;                    //!< The return address of the error.
+  char what[ERROR_WHAT_LENGTH];   //!< The error explanation.
+} error_record_t;
+
 /** \brief Error structure
+  * 
+  * The error explanation is stored in a buffer of fixed size, and longer
+  * explanations will be truncated. The chain of blamed errors is stored
+  * by value and truncated after ERROR_MAX_BLAMES records, discarding the
+  * deepest causes. Setting, copying, and clearing an error therefore
+  * never allocates memory.
   */
 typedef struct error_t {
   int code;                       //!< The error code.
   const char** descriptions;      //!< The error descriptions.
   
-  char* where;                    //!< The location of the error.
-  char* what;                     //!< The error explanation.
+  void* where;                    //!< The return address of the error.
+  char what[ERROR_WHAT_LENGTH];   //!< The error explanation.
   
-  struct error_t* blame;          //!< The error to blame.
+  error_record_t blame[ERROR_MAX_BLAMES]; //!< The chain of blamed errors.
+  size_t num_blames;              //!< The number of blamed errors.
 } error_t;
 
 /** \brief Error debugging flag
@@ -58,6 +86,17 @@ typedef struct error_t {
   */
 extern int error_debug;
 
+/** \brief Error location flag
+  * \note This flag influences the functions setting an error.
+  * 
+  * If the error location flag is non-zero, the functions setting an error
+  * record the return address of their caller as the error location. The
+  * return address is resolved into a symbol name by error_print() only.
+  * Setting this flag to zero or compiling the library with ERROR_NO_WHERE
+  * defined disables the recording of error locations.
+  */
+extern int error_where;
+
 /** \brief Initialize error
   * \param[in] error The error to be initialized.
   * \param[in] descriptions The local descriptions of the error to be
@@ -104,7 +143,8 @@ void error_set(
   * \param[in] code The code to be set for the error.
   * 
   * The concept of blaming allows for giving the cause of an error in
-  * the form of an underlying error.
+  * the form of an underlying error. The blamed error and its own chain of
+  * blamed errors are copied into the chain of the error.
   */
 void error_blame(
   error_t* error,
@@ -152,6 +192,24 @@ void error_blamef(
 int error_get(
   const error_t* error);
 
+/** \brief Retrieve the calling thread's last error
+  * \param[out] record The error record receiving the last error set by the
+  *   calling thread.
+  * \return The code of the last error set by the calling thread.
+  * 
+  * Each thread maintains a thread-local record of the last error with a
+  * non-zero code it has set through any of the error functions. Like errno,
+  * this record is not affected by clearing errors and thus persists until
+  * the thread sets another error or calls error_clear_last(). It remains
+  * valid even if the error object has been modified by another thread.
+  */
+int error_get_last(
+  error_record_t* record);
+
+/** \brief Clear the calling thread's last error
+  */
+void error_clear_last(void);
+
 /** \brief Retrieve error description
   * \param[in] error The error to retrieve the description for.
   * \return The error description.
@@ -164,15 +222,15 @@ const char* error_get_description(
   * \return The zero error code.
   * 
   * Clearing an error simply is the process of setting a zero error code
-  * and destroying its blame.
+  * and discarding its explanation and blame.
   */
 void error_clear(
   error_t* error);
 
 /** \brief Print error
-  * \note The error locations are determined using the function backtrace().
-  *   For compiler optimization levels other than zero, they may turn out
-  *   to be wrong.
+  * \note The error locations are resolved using the function
+  *   backtrace_symbols(). For compiler optimization levels other than zero,
+  *   they may turn out to be wrong.
   * \param[in] stream The output stream that will be used for printing the
   *   error.
   * \param[in] error The error that will be printed.
@@ -0,0 +1,164 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "stats.h"
+
+int error_stats = 0;
+
+error_stats_entry_t error_stats_entries[ERROR_STATS_MAX_MODULES];
+error_stats_thread_t* error_stats_threads = 0;
+
+pthread_once_t error_stats_once = PTHREAD_ONCE_INIT;
+pthread_key_t error_stats_key;
+
+__thread error_stats_thread_t* error_stats_thread = 0;
+
+error_stats_entry_t* error_stats_find(const char** descriptions, int add);
+void error_stats_create_key(void);
+void error_stats_release_thread(void* thread);
+error_stats_thread_t* error_stats_register_thread(void);
+size_t error_stats_count(size_t module, size_t code);
+
+void error_stats_add(const error_t* error) {
+  error_stats_entry_t* entry;
+  error_stats_thread_t* thread = error_stats_thread;
+  
+  if ((error->code > 0) && (error->code < ERROR_STATS_MAX_CODES) &&
+      (entry = error_stats_find(error->descriptions, 1)) &&
+      (thread || (thread = error_stats_register_thread())))
+    ++thread->counts[entry-error_stats_entries][error->code];
+}
+
+size_t error_stats_get(const char** descriptions, int code) {
+  error_stats_entry_t* entry;
+  
+  if ((code >= 0) && (code < ERROR_STATS_MAX_CODES) &&
+      (entry = error_stats_find(descriptions, 0)))
+    return error_stats_count(entry-error_stats_entries, code)-
+      entry->resets[code];
+  else
+    return 0;
+}
+
+size_t error_stats_get_total(void) {
+  size_t i, j, count = 0;
+  
+  for (i = 0; (i < ERROR_STATS_MAX_MODULES) &&
+      error_stats_entries[i].descriptions; ++i)
+    for (j = 0; j < ERROR_STATS_MAX_CODES; ++j)
+      count += error_stats_count(i, j)-error_stats_entries[i].resets[j];
+  
+  return count;
+}
+
+void error_stats_reset(void) {
+  size_t i, j;
+  
+  for (i = 0; (i < ERROR_STATS_MAX_MODULES) &&
+      error_stats_entries[i].descriptions; ++i)
+    for (j = 0; j < ERROR_STATS_MAX_CODES; ++j)
+      error_stats_entries[i].resets[j] = error_stats_count(i, j);
+}
+
+void error_stats_print(FILE* stream) {
+  size_t i, j;
+  
+  for (i = 0; (i < ERROR_STATS_MAX_MODULES) &&
+      error_stats_entries[i].descriptions; ++i)
+    for (j = 0; j < ERROR_STATS_MAX_CODES; ++j) {
+      size_t count = error_stats_count(i, j)-
+        error_stats_entries[i].resets[j];
+      
+      if (count)
+        fprintf(stream, "%3d %s: %lu\n", (int)j,
+          error_stats_entries[i].descriptions[j], count);
+    }
+}
+
+error_stats_entry_t* error_stats_find(const char** descriptions, int add) {
+  size_t i;
+  
+  if (!descriptions)
+    return 0;
+  
+  for (i = 0; i < ERROR_STATS_MAX_MODULES; ++i) {
+    const char** entry_descriptions = error_stats_entries[i].descriptions;
+    
+    if (entry_descriptions == descriptions)
+      return &error_stats_entries[i];
+    else if (!entry_descriptions) {
+      if (!add)
+        return 0;
+      entry_descriptions = __sync_val_compare_and_swap(
+        &error_stats_entries[i].descriptions, 0, descriptions);
+      if (!entry_descriptions || (entry_descriptions == descriptions))
+        return &error_stats_entries[i];
+    }
+  }
+  
+  return 0;
+}
+
+void error_stats_create_key(void) {
+  pthread_key_create(&error_stats_key, error_stats_release_thread);
+}
+
+void error_stats_release_thread(void* thread) {
+  __sync_lock_release(&((error_stats_thread_t*)thread)->active);
+}
+
+error_stats_thread_t* error_stats_register_thread(void) {
+  error_stats_thread_t* thread;
+  
+  pthread_once(&error_stats_once, error_stats_create_key);
+  
+  for (thread = error_stats_threads; thread; thread = thread->next)
+    if (!__sync_lock_test_and_set(&thread->active, 1))
+      break;
+  
+  if (!thread && (thread = calloc(1, sizeof(error_stats_thread_t)))) {
+    thread->active = 1;
+    do {
+      thread->next = error_stats_threads;
+    }
+    while (!__sync_bool_compare_and_swap(&error_stats_threads, thread->next,
+      thread));
+  }
+  
+  if (thread) {
+    pthread_setspecific(error_stats_key, thread);
+    error_stats_thread = thread;
+  }
+  
+  return thread;
+}
+
+size_t error_stats_count(size_t module, size_t code) {
+  const error_stats_thread_t* thread;
+  size_t count = 0;
+  
+  for (thread = error_stats_threads; thread; thread = thread->next)
+    count += ((volatile const size_t*)thread->counts[module])[code];
+  
+  return count;
+}
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef ERROR_STATS_H
+#define ERROR_STATS_H
+
+/** \file error/stats.h
+  * \ingroup error
+  * \brief Error statistics interface
+  * \author Ralf Kaestner
+  * 
+  * The error statistics interface provides a process-wide registry of
+  * counters for the errors set by any thread. Errors are counted per set
+  * of error descriptions, i.e., per module, and per error code. Each
+  * thread increments its own counters, which are aggregated over all
+  * threads when the statistics are queried.
+  */
+
+#include <stdio.h>
+
+#include "error/error.h"
+
+/** \brief Predefined maximum number of modules in the error statistics
+  */
+#define ERROR_STATS_MAX_MODULES             64
+
+/** \brief Predefined maximum number of error codes per module in the error
+  *   statistics
+  */
+#define ERROR_STATS_MAX_CODES               32
+
+/** \brief Error statistics entry structure
+  */
+typedef struct error_stats_entry_t {
+  const char** descriptions;      //!< The error descriptions of the module.
+  size_t resets[ERROR_STATS_MAX_CODES]; //!< The error counts at reset.
+} error_stats_entry_t;
+
+/** \brief Error statistics thread structure
+  * 
+  * The thread structure holds the error counters of a single thread. The
+  * counters of each module are stored at the index of the module's entry.
+  * A structure whose thread has terminated is inactive and will be taken
+  * over by the next thread that registers with the statistics.
+  */
+typedef struct error_stats_thread_t {
+  size_t counts[ERROR_STATS_MAX_MODULES][ERROR_STATS_MAX_CODES];
+    //!< The error counts of the thread.
+  int active;                        //!< Non-zero if owned by a thread.
+  struct error_stats_thread_t* next; //!< The next registered thread.
+} error_stats_thread_t;
+
+/** \brief Error statistics flag
+  * \note This flag influences the functions setting an error.
+  * 
+  * If the error statistics flag is non-zero, the functions setting an
+  * error with a non-zero code will count it by means of error_stats_add().
+  * The flag is zero by default, such that an application monitoring its
+  * error rates must enable the statistics explicitly.
+  */
+extern int error_stats;
+
+/** \brief Count error
+  * \param[in] error The error to be counted.
+  * 
+  * The calling thread's counter of the error's code is incremented without
+  * any atomic operation. The first error of a module registers the
+  * module's descriptions with the statistics, using an atomic
+  * compare-and-swap operation on a free entry. The first error of a thread
+  * takes over the counters of a terminated thread or, if there is none,
+  * allocates new counters and registers them by means of another
+  * compare-and-swap operation. Thus, this function never blocks. Errors of
+  * modules exceeding the maximum number of modules and codes exceeding the
+  * maximum number of codes will not be counted.
+  * 
+  * The counters of a thread are retained after the thread terminates, such
+  * that its errors remain accounted for in the statistics. Since a new
+  * thread continues counting on these counters, the memory occupied by the
+  * statistics is bounded by the maximum number of concurrent threads.
+  */
+void error_stats_add(
+  const error_t* error);
+
+/** \brief Retrieve error count
+  * \param[in] descriptions The error descriptions of the module to
+  *   retrieve the error count for.
+  * \param[in] code The error code to retrieve the count for.
+  * \return The number of errors counted for the given module and code by
+  *   all threads since the last reset.
+  */
+size_t error_stats_get(
+  const char** descriptions,
+  int code);
+
+/** \brief Retrieve total error count
+  * \return The number of errors counted for all modules and codes.
+  */
+size_t error_stats_get_total(void);
+
+/** \brief Reset error statistics
+  * 
+  * All error counts are reset to zero, whereas the registered modules are
+  * retained. Since the counters are owned by their threads, the reset
+  * records the current counts as the new origin of the statistics rather
+  * than modifying the counters.
+  */
+void error_stats_reset(void);
+
+/** \brief Print error statistics
+  * \param[in] stream The output stream that will be used for printing the
+  *   error statistics.
+  * 
+  * For each non-zero error counter, this function prints a line
+  * containing the error's code, description, and count. Since the counters
+  * may be modified concurrently, the printed counts represent a snapshot.
+  */
+void error_stats_print(
+  FILE* stream);
+
+#endif
@@ -394,13 +394,13 @@ ssize_t file_read(file_t* file, unsigned char* data, size_t size) {
   ssize_t result;
   switch (file->compression) {
     case file_compression_gzip:
-      if ((result = gzread(file->handle, data, size)) <= 0) {
+      if ((result = gzread(file->handle, data, size)) < 0) {
         error_setf(&file->error, FILE_ERROR_READ, file->name);
         return -error_get(&file->error);
       }
       break;
     case file_compression_bzip2:
-      if ((result = BZ2_bzread(file->handle, data, size)) <= 0) {
+      if ((result = BZ2_bzread(file->handle, data, size)) < 0) {
         error_setf(&file->error, FILE_ERROR_READ, file->name);
         return -error_get(&file->error);
       }
@@ -408,7 +408,7 @@ ssize_t file_read(file_t* file, unsigned char* data, size_t size) {
         file->pos += result;
       break;
     default:
-      if (!(result = fread(data, size, 1, file->handle)) &&
+      if (!(result = fread(data, 1, size, file->handle)) &&
           ferror(file->handle)) {
         error_setf(&file->error, FILE_ERROR_READ, file->name);
         return -error_get(&file->error);
@@ -443,7 +443,7 @@ ssize_t file_write(file_t* file, const unsigned char* data, size_t size) {
         file->pos += result;
       break;
     default:
-      if (!(result = fwrite(data, size, 1, file->handle))) {
+      if ((result = fwrite(data, 1, size, file->handle)) < size) {
         error_setf(&file->error, FILE_ERROR_WRITE, file->name);
         return -error_get(&file->error);
       }
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "reader.h"
+
+void file_reader_init(file_reader_t* reader, file_t* file, size_t size) {
+  reader->file = file;
+  
+  reader->size = size ? size : FILE_READER_DEFAULT_SIZE;
+  reader->buffer = malloc(reader->size);
+  reader->begin = 0;
+  reader->end = 0;
+  
+  reader->eof = 0;
+}
+
+void file_reader_destroy(file_reader_t* reader) {
+  if (reader->buffer)
+    free(reader->buffer);
+  
+  reader->buffer = 0;
+  reader->size = 0;
+  reader->begin = 0;
+  reader->end = 0;
+}
+
+int file_reader_eof(const file_reader_t* reader) {
+  return (reader->begin == reader->end) && reader->eof;
+}
+
+ssize_t file_reader_read_line(file_reader_t* reader, char** line) {
+  char* new_line;
+  ssize_t result;
+  
+  while (!(new_line = memchr(&reader->buffer[reader->begin], '\n',
+      reader->end-reader->begin)) && !reader->eof) {
+    if (reader->begin) {
+      memmove(reader->buffer, &reader->buffer[reader->begin],
+        reader->end-reader->begin);
+      reader->end -= reader->begin;
+      reader->begin = 0;
+    }
+    
+    if (reader->end+1 >= reader->size) {
+      reader->size *= 2;
+      reader->buffer = realloc(reader->buffer, reader->size);
+    }
+    
+    if ((result = file_read(reader->file,
+        (unsigned char*)&reader->buffer[reader->end],
+        reader->size-reader->end-1)) > 0)
+      reader->end += result;
+    else if (!result)
+      reader->eof = 1;
+    else
+      return result;
+  }
+  
+  *line = &reader->buffer[reader->begin];
+  if (new_line) {
+    result = new_line-*line;
+    reader->begin += result+1;
+  }
+  else {
+    result = reader->end-reader->begin;
+    reader->begin = reader->end;
+  }
+  (*line)[result] = 0;
+  
+  return result;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef FILE_READER_H
+#define FILE_READER_H
+
+/** \file file/reader.h
+  * \ingroup file
+  * \brief Block-buffered file reader implementation
+  * \author Ralf Kaestner
+  * 
+  * The block-buffered file reader reads large blocks of data from an open
+  * file and provides line-wise access to the buffered data. Compared to
+  * file_read_line(), which reads single characters, it thus reduces the
+  * number of read operations by orders of magnitude, in particular for
+  * compressed files.
+  */
+
+#include "file/file.h"
+
+/** \brief The default buffer size of a file reader in bytes
+  */
+#define FILE_READER_DEFAULT_SIZE                65536
+
+/** \brief File reader structure
+  */
+typedef struct file_reader_t {
+  file_t* file;                     //!< The open file read from.
+
+  char* buffer;                     //!< The buffer of the file reader.
+  size_t size;                      //!< The size of the buffer.
+  size_t begin;                     //!< The start of the unread data.
+  size_t end;                       //!< The end of the buffered data.
+  
+  int eof;                          //!< The end-of-file indicator.
+} file_reader_t;
+
+/** \brief Initialize file reader
+  * \param[in] reader The file reader to be initialized.
+  * \param[in] file The open file to be read from.
+  * \param[in] size The initial size of the reader's buffer. If zero, the
+  *   buffer size will default to FILE_READER_DEFAULT_SIZE.
+  */
+void file_reader_init(
+  file_reader_t* reader,
+  file_t* file,
+  size_t size);
+
+/** \brief Destroy file reader
+  * \param[in] reader The file reader to be destroyed.
+  * 
+  * The file read from will not be closed.
+  */
+void file_reader_destroy(
+  file_reader_t* reader);
+
+/** \brief Retrieve the end-of-file indicator of a file reader
+  * \param[in] reader The file reader to retrieve the end-of-file indicator
+  *   for.
+  * \return One if the end of the file has been reached and all buffered
+  *   data has been read, zero otherwise.
+  */
+int file_reader_eof(
+  const file_reader_t* reader);
+
+/** \brief Read line using a file reader
+  * \param[in] reader The file reader to read the line with.
+  * \param[out] line The pointer to the read line, excluding the trailing
+  *   new-line character. The line resides in the reader's buffer and
+  *   remains valid until the next call to this function.
+  * \return The number of line characters read or the negative error code
+  *   of the file.
+  * 
+  * If a line exceeds the size of the reader's buffer, the buffer will
+  * grow to twice its size.
+  */
+ssize_t file_reader_read_line(
+  file_reader_t* reader,
+  char** line);
+
+#endif
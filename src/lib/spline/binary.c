@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+#include <limits.h>
+
+#include "binary.h"
+
+#include "spline/knot.h"
+#include "spline/segment.h"
+
+void spline_binary_header_init(spline_binary_header_t* header, size_t
+    num_knots, uint32_t flags) {
+  memcpy(header->magic, SPLINE_BINARY_MAGIC, sizeof(header->magic));
+  header->version = SPLINE_BINARY_VERSION;
+  header->byte_order = SPLINE_BINARY_BYTE_ORDER;
+  header->flags = flags;
+  header->num_knots = num_knots;
+  header->checksum = 0;
+}
+
+int spline_binary_header_valid(const spline_binary_header_t* header) {
+  return !memcmp(header->magic, SPLINE_BINARY_MAGIC, sizeof(header->magic)) &&
+    (header->version == SPLINE_BINARY_VERSION) &&
+    (header->byte_order == SPLINE_BINARY_BYTE_ORDER);
+}
+
+ssize_t spline_binary_get_payload_size(const spline_binary_header_t*
+    header) {
+  size_t size;
+  
+  if (header->num_knots > SSIZE_MAX/sizeof(spline_knot_t))
+    return -1;
+  size = header->num_knots*sizeof(spline_knot_t);
+  
+  if ((header->flags & SPLINE_BINARY_FLAG_SEGMENTS) &&
+      (header->num_knots > 1)) {
+    if (header->num_knots-1 > (SSIZE_MAX-size)/sizeof(spline_segment_t))
+      return -1;
+    size += (header->num_knots-1)*sizeof(spline_segment_t);
+  }
+  
+  return size;
+}
+
+size_t spline_binary_get_max_knots(const spline_binary_header_t* header,
+    size_t size) {
+  if (size < sizeof(spline_binary_header_t))
+    return 0;
+  size -= sizeof(spline_binary_header_t);
+  
+  if (header->flags & SPLINE_BINARY_FLAG_SEGMENTS) {
+    if (size < sizeof(spline_knot_t))
+      return size/sizeof(spline_knot_t);
+    else
+      return (size-sizeof(spline_knot_t))/(sizeof(spline_knot_t)+
+        sizeof(spline_segment_t))+1;
+  }
+  else
+    return size/sizeof(spline_knot_t);
+}
+
+uint64_t spline_binary_checksum(uint64_t checksum, const void* data, size_t
+    size) {
+  const uint64_t* words = data;
+  size_t i;
+  
+  if (!checksum)
+    checksum = 0xcbf29ce484222325ULL;
+  
+  for (i = 0; i < size/sizeof(uint64_t); ++i)
+    checksum = (checksum^words[i])*0x100000001b3ULL;
+  
+  return checksum;
+}
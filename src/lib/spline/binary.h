@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_BINARY_H
+#define SPLINE_BINARY_H
+
+/** \file spline/binary.h
+  * \ingroup spline
+  * \brief Binary file format definitions for cubic splines
+  * \author Ralf Kaestner
+  * 
+  * A binary spline file consists in a fixed-size header, followed by the
+  * array of spline knots and, optionally, the array of cached spline
+  * segments. All values are stored in host byte order, such that the
+  * arrays of an uncompressed file may be memory-mapped without conversion.
+  */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/** \brief The magic identifier of a binary spline file
+  */
+#define SPLINE_BINARY_MAGIC                   "SPLN"
+
+/** \brief The version of the binary spline file format
+  */
+#define SPLINE_BINARY_VERSION                 1
+
+/** \brief The byte order mark of a binary spline file
+  */
+#define SPLINE_BINARY_BYTE_ORDER              0x01020304
+
+/** \name Flags
+  * \brief Predefined binary spline file flags
+  */
+//@{
+#define SPLINE_BINARY_FLAG_SEGMENTS           0x00000001
+//!< File contains cached spline segments
+//@}
+
+/** \brief Structure defining the header of a binary spline file
+  * 
+  * The size of the header is a multiple of 8 bytes, such that the arrays
+  * following the header are suitably aligned for memory-mapping.
+  */
+typedef struct spline_binary_header_t {
+  char magic[4];                //!< The magic identifier of the file.
+  uint32_t version;             //!< The version of the file format.
+  uint32_t byte_order;          //!< The byte order mark of the file.
+  uint32_t flags;               //!< The flags of the file.
+  uint64_t num_knots;           //!< The number of spline knots in the file.
+  uint64_t checksum;            //!< The checksum of the knots and segments.
+} spline_binary_header_t;
+
+/** \brief Initialize a binary spline file header
+  * \param[in] header The binary spline file header to be initialized.
+  * \param[in] num_knots The number of spline knots in the file.
+  * \param[in] flags The flags of the file.
+  */
+void spline_binary_header_init(
+  spline_binary_header_t* header,
+  size_t num_knots,
+  uint32_t flags);
+
+/** \brief Validate a binary spline file header
+  * \param[in] header The binary spline file header to be validated.
+  * \return Non-zero if the magic identifier, the version, and the byte
+  *   order mark of the header are valid, zero otherwise.
+  */
+int spline_binary_header_valid(
+  const spline_binary_header_t* header);
+
+/** \brief Retrieve the payload size of a binary spline file
+  * \param[in] header The valid binary spline file header to retrieve the
+  *   payload size for.
+  * \return The size of the knot and segment arrays following the header
+  *   in bytes or a negative value if the size overflows.
+  */
+ssize_t spline_binary_get_payload_size(
+  const spline_binary_header_t* header);
+
+/** \brief Retrieve the maximum number of knots of a binary spline file
+  * \param[in] header The valid binary spline file header to retrieve the
+  *   maximum number of knots for.
+  * \param[in] size The size of the binary spline file in bytes, including
+  *   the header.
+  * \return The maximum number of knots which fit into a file of the
+  *   specified size, considering the flags of the header.
+  * 
+  * The result does not involve any multiplication by the number of knots
+  * stored in the header and may thus be used to validate untrusted headers.
+  */
+size_t spline_binary_get_max_knots(
+  const spline_binary_header_t* header,
+  size_t size);
+
+/** \brief Update the checksum of binary spline data
+  * \param[in] checksum The checksum of any preceding data or zero.
+  * \param[in] data The data to update the checksum with.
+  * \param[in] size The size of the data in bytes, a multiple of 8.
+  * \return The updated checksum.
+  * 
+  * The checksum is a 64-bit FNV-1a hash computed over 64-bit words rather
+  * than single bytes, such that it may be updated at memory bandwidth.
+  */
+uint64_t spline_binary_checksum(
+  uint64_t checksum,
+  const void* data,
+  size_t size);
+
+#endif
@@ -0,0 +1,613 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "curve.h"
+
+#include "spline/tridiag.h"
+
+size_t spline_curve_reserve_knots(spline_curve_t* curve, size_t num_knots);
+const size_t* spline_curve_update_index(spline_curve_t* curve);
+ssize_t spline_curve_prepare(spline_curve_t* curve, size_t num_points,
+  size_t num_channels);
+ssize_t spline_curve_int(spline_curve_t* curve, int periodic);
+const double* spline_curve_update_lengths(spline_curve_t* curve);
+double spline_curve_eval_speed(const spline_curve_t* curve, size_t index,
+  double x);
+double spline_curve_integrate_speed(const spline_curve_t* curve, size_t
+  index, double a, double b);
+
+const double spline_curve_gauss_legendre_nodes[] = {
+  -0.906179845938663992797627,
+  -0.538469310105683091036314,
+  0.0,
+  0.538469310105683091036314,
+  0.906179845938663992797627,
+};
+
+const double spline_curve_gauss_legendre_weights[] = {
+  0.236926885056189087514264,
+  0.478628670499366468041292,
+  0.568888888888888888888889,
+  0.478628670499366468041292,
+  0.236926885056189087514264,
+};
+
+void spline_curve_init(spline_curve_t* curve, size_t num_channels) {
+  curve->x = 0;
+  curve->y = 0;
+  curve->y2 = 0;
+  curve->num_knots = 0;
+  curve->num_channels = num_channels;
+  curve->capacity = 0;
+  
+  curve->index = 0;
+  curve->num_buckets = 0;
+  curve->bucket_scale = 0.0;
+  
+  curve->lengths = 0;
+  curve->num_lengths = 0;
+  
+  spline_workspace_init(&curve->workspace);
+  
+  error_init(&curve->error, spline_errors);
+}
+
+void spline_curve_destroy(spline_curve_t* curve) {
+  spline_curve_clear(curve);
+  
+  spline_workspace_destroy(&curve->workspace);
+  error_destroy(&curve->error);
+}
+
+void spline_curve_clear(spline_curve_t* curve) {
+  if (curve->x) {
+    free(curve->x);
+    
+    curve->x = 0;
+    curve->y = 0;
+    curve->y2 = 0;
+    curve->num_knots = 0;
+    curve->capacity = 0;
+  }
+  
+  if (curve->index) {
+    free(curve->index);
+    
+    curve->index = 0;
+    curve->num_buckets = 0;
+  }
+  
+  if (curve->lengths) {
+    free(curve->lengths);
+    
+    curve->lengths = 0;
+    curve->num_lengths = 0;
+  }
+  
+  error_clear(&curve->error);
+}
+
+size_t spline_curve_reserve_knots(spline_curve_t* curve, size_t num_knots) {
+  double* x;
+  
+  if (num_knots > curve->capacity) {
+    size_t capacity = curve->capacity ? 2*curve->capacity : 1;
+    if (capacity < num_knots)
+      capacity = num_knots;
+    
+    if (capacity > SIZE_MAX/((2*curve->num_channels+1)*sizeof(double)))
+      return curve->capacity;
+    x = malloc((2*curve->num_channels+1)*capacity*sizeof(double));
+    if (!x)
+      return curve->capacity;
+    
+    if (curve->x)
+      free(curve->x);
+    
+    curve->x = x;
+    curve->y = &curve->x[capacity];
+    curve->y2 = &curve->y[curve->num_channels*capacity];
+    
+    curve->num_knots = 0;
+    curve->capacity = capacity;
+  }
+  
+  return curve->capacity;
+}
+
+const size_t* spline_curve_update_index(spline_curve_t* curve) {
+  if (!curve->num_buckets && (curve->num_knots > 1)) {
+    size_t num_buckets = curve->num_knots-1;
+    double x_0 = curve->x[0];
+    size_t i, j = 0;
+    
+    curve->index = realloc(curve->index, (num_buckets+1)*sizeof(size_t));
+    curve->bucket_scale = num_buckets/(curve->x[curve->num_knots-1]-x_0);
+    
+    for (i = 0; i < num_buckets; ++i) {
+      double x_i = x_0+i/curve->bucket_scale;
+      
+      while ((j+2 < curve->num_knots) && (curve->x[j+1] <= x_i))
+        ++j;
+      curve->index[i] = j;
+    }
+    curve->index[num_buckets] = curve->num_knots-2;
+    
+    curve->num_buckets = num_buckets;
+  }
+  
+  return curve->index;
+}
+
+ssize_t spline_curve_prepare(spline_curve_t* curve, size_t num_points,
+    size_t num_channels) {
+  error_clear(&curve->error);
+  
+  curve->num_knots = 0;
+  curve->num_buckets = 0;
+  curve->num_lengths = 0;
+  
+  if (curve->num_channels && (curve->num_channels == num_channels)) {
+    if ((num_points > 1) &&
+        (spline_curve_reserve_knots(curve, num_points) >= num_points))
+      curve->num_knots = num_points;
+    else
+      error_set(&curve->error, SPLINE_ERROR_INTERPOLATION);
+  }
+  else
+    error_setf(&curve->error, SPLINE_ERROR_CHANNELS, "%d",
+      (int)curve->num_channels);
+  
+  return curve->error.code ? -curve->error.code : curve->num_knots;
+}
+
+ssize_t spline_curve_int(spline_curve_t* curve, int periodic) {
+  spline_workspace_t* workspace = &curve->workspace;
+  size_t n = curve->num_knots;
+  size_t m = periodic ? n-1 : n;
+  size_t num_channels = curve->num_channels;
+  size_t capacity = curve->capacity;
+  const double* x = curve->x;
+  const double* y = curve->y;
+  double* y2 = curve->y2;
+  size_t i, k;
+  int result;
+  
+  if (n < 3) {
+    curve->num_knots = 0;
+    error_set(&curve->error, SPLINE_ERROR_INTERPOLATION);
+    
+    return -curve->error.code;
+  }
+  
+  if (spline_workspace_reserve(workspace, m) < m) {
+    curve->num_knots = 0;
+    error_set(&curve->error, SPLINE_ERROR_INTERPOLATION);
+    
+    return -curve->error.code;
+  }
+  
+  double* c = workspace->c;
+  double* d = workspace->d;
+  double* e = workspace->e;
+  
+  double h_i, h_j = 0.0;
+  for (i = 1; i < n-1; ++i) {
+    h_i = (i > 1) ? h_j : x[i]-x[i-1];
+    h_j = x[i+1]-x[i];
+    
+    if (periodic)
+      e[i-1] = h_i;
+    else {
+      c[i-1] = h_i;
+      e[i] = h_j;
+    }
+    d[i] = 2.0*(h_i+h_j);
+    
+    for (k = 0; k < num_channels; ++k) {
+      const double* y_k = &y[k*capacity];
+      y2[k*capacity+i] = 6.0*((y_k[i+1]-y_k[i])/h_j-
+        (y_k[i]-y_k[i-1])/h_i);
+    }
+  }
+  
+  if (periodic) {
+    double h_1 = x[1]-x[0];
+    double h_m = x[n-1]-x[n-2];
+    
+    d[0] = 2.0*(h_1+h_m);
+    e[n-2] = h_m;
+    for (k = 0; k < num_channels; ++k) {
+      const double* y_k = &y[k*capacity];
+      y2[k*capacity] = 6.0*((y_k[1]-y_k[0])/h_1-(y_k[n-1]-y_k[n-2])/h_m);
+    }
+    
+    if (!(result = spline_tridiag_factor_symm_cyc(d, e, workspace->w,
+        workspace->m, workspace->z, m))) {
+      spline_tridiag_solve_factor_symm_cyc(d, e, workspace->w,
+        workspace->m, workspace->z, y2, m, num_channels, capacity);
+      for (k = 0; k < num_channels; ++k)
+        y2[k*capacity+n-1] = y2[k*capacity];
+    }
+  }
+  else {
+    d[0] = 1.0;
+    e[0] = 0.0;
+    c[n-2] = 0.0;
+    d[n-1] = 1.0;
+    for (k = 0; k < num_channels; ++k) {
+      y2[k*capacity] = 0.0;
+      y2[k*capacity+n-1] = 0.0;
+    }
+    
+    if (!(result = spline_tridiag_factor(c, d, e, workspace->w,
+        workspace->m, m)))
+      spline_tridiag_solve_factor(c, workspace->w, workspace->m, y2, m,
+        num_channels, capacity);
+  }
+  
+  if (result) {
+    curve->num_knots = 0;
+    error_set(&curve->error, result);
+  }
+  
+  return curve->error.code ? -curve->error.code : curve->num_knots;
+}
+
+ssize_t spline_curve_int_natural(spline_curve_t* curve, const double* x,
+    const double* y, size_t num_points) {
+  if (spline_curve_prepare(curve, num_points, curve->num_channels) >= 0) {
+    size_t k;
+    
+    memcpy(curve->x, x, num_points*sizeof(double));
+    for (k = 0; k < curve->num_channels; ++k)
+      memcpy(&curve->y[k*curve->capacity], &y[k*num_points],
+        num_points*sizeof(double));
+    
+    return spline_curve_int(curve, 0);
+  }
+  
+  return -curve->error.code;
+}
+
+ssize_t spline_curve_int_periodic(spline_curve_t* curve, const double* x,
+    const double* y, size_t num_points) {
+  if (spline_curve_prepare(curve, num_points, curve->num_channels) >= 0) {
+    size_t k;
+    
+    memcpy(curve->x, x, num_points*sizeof(double));
+    for (k = 0; k < curve->num_channels; ++k)
+      memcpy(&curve->y[k*curve->capacity], &y[k*num_points],
+        num_points*sizeof(double));
+    
+    return spline_curve_int(curve, 1);
+  }
+  
+  return -curve->error.code;
+}
+
+ssize_t spline_curve_int_points(spline_curve_t* curve, const double* x,
+    const transform_point_t* points, size_t num_points, int periodic) {
+  if (spline_curve_prepare(curve, num_points,
+      SPLINE_CURVE_POINT_CHANNELS) >= 0) {
+    double* y = curve->y;
+    size_t capacity = curve->capacity;
+    size_t i;
+    
+    for (i = 0; i < num_points; ++i) {
+      curve->x[i] = x[i];
+      
+      y[i] = points[i].x;
+      y[capacity+i] = points[i].y;
+      y[2*capacity+i] = points[i].z;
+    }
+    
+    return spline_curve_int(curve, periodic);
+  }
+  
+  return -curve->error.code;
+}
+
+ssize_t spline_curve_int_poses(spline_curve_t* curve, const double* x,
+    const transform_pose_t* poses, size_t num_poses, int periodic) {
+  if (spline_curve_prepare(curve, num_poses,
+      SPLINE_CURVE_POSE_CHANNELS) >= 0) {
+    double* y = curve->y;
+    size_t capacity = curve->capacity;
+    size_t i;
+    
+    for (i = 0; i < num_poses; ++i) {
+      curve->x[i] = x[i];
+      
+      y[i] = poses[i].x;
+      y[capacity+i] = poses[i].y;
+      y[2*capacity+i] = poses[i].z;
+      y[3*capacity+i] = poses[i].yaw;
+      y[4*capacity+i] = poses[i].pitch;
+      y[5*capacity+i] = poses[i].roll;
+    }
+    
+    return spline_curve_int(curve, periodic);
+  }
+  
+  return -curve->error.code;
+}
+
+ssize_t spline_curve_graph(spline_curve_t* curve, const spline_t* spline) {
+  if (spline_curve_prepare(curve, spline->num_knots,
+      SPLINE_CURVE_GRAPH_CHANNELS) >= 0) {
+    size_t capacity = curve->capacity;
+    size_t i;
+    
+    for (i = 0; i < spline->num_knots; ++i) {
+      curve->x[i] = spline->knots[i].x;
+      
+      curve->y[i] = spline->knots[i].x;
+      curve->y2[i] = 0.0;
+      curve->y[capacity+i] = spline->knots[i].y;
+      curve->y2[capacity+i] = spline->knots[i].y2;
+    }
+    
+    return curve->num_knots;
+  }
+  
+  return -curve->error.code;
+}
+
+ssize_t spline_curve_find_segment(spline_curve_t* curve, double x) {
+  const double* x_k = curve->x;
+  
+  error_clear(&curve->error);
+  spline_curve_update_index(curve);
+  
+  if ((curve->num_knots > 1) && (x >= x_k[0]) &&
+      (x <= x_k[curve->num_knots-1])) {
+    size_t b = (x-x_k[0])*curve->bucket_scale;
+    if (b >= curve->num_buckets)
+      b = curve->num_buckets-1;
+    
+    size_t i = curve->index[b];
+    size_t j = curve->index[b+1]+1;
+    
+    if (x < x_k[i])
+      i = 0;
+    if (x > x_k[j])
+      j = curve->num_knots-1;
+    
+    while (j-i > 1) {
+      size_t l = (i+j) >> 1;
+      if (x_k[l] > x)
+        j = l;
+      else
+        i = l;
+    }
+    
+    return i;
+  }
+  
+  error_setf(&curve->error, SPLINE_ERROR_UNDEFINED, "%lg", x);
+  return -curve->error.code;
+}
+
+int spline_curve_eval(spline_curve_t* curve, spline_eval_type_t eval_type,
+    double x, double* values) {
+  ssize_t i;
+  size_t k;
+  
+  if ((i = spline_curve_find_segment(curve, x)) >= 0) {
+    double h = curve->x[i+1]-curve->x[i];
+    double u = (curve->x[i+1]-x)/h;
+    double v = (x-curve->x[i])/h;
+    double w_y_0, w_y_1, w_y2_0, w_y2_1;
+    
+    if (eval_type == spline_eval_type_first_derivative) {
+      w_y_0 = -1.0/h;
+      w_y_1 = 1.0/h;
+      w_y2_0 = -(3.0*u*u-1.0)*h/6.0;
+      w_y2_1 = (3.0*v*v-1.0)*h/6.0;
+    }
+    else if (eval_type == spline_eval_type_second_derivative) {
+      w_y_0 = 0.0;
+      w_y_1 = 0.0;
+      w_y2_0 = u;
+      w_y2_1 = v;
+    }
+    else {
+      w_y_0 = u;
+      w_y_1 = v;
+      w_y2_0 = (u*u-1.0)*u*h*h/6.0;
+      w_y2_1 = (v*v-1.0)*v*h*h/6.0;
+    }
+    
+    for (k = 0; k < curve->num_channels; ++k) {
+      const double* y = &curve->y[k*curve->capacity+i];
+      const double* y2 = &curve->y2[k*curve->capacity+i];
+      
+      values[k] = w_y_0*y[0]+w_y_1*y[1]+w_y2_0*y2[0]+w_y2_1*y2[1];
+    }
+  }
+  else
+    for (k = 0; k < curve->num_channels; ++k)
+      values[k] = NAN;
+  
+  return curve->error.code;
+}
+
+const double* spline_curve_update_lengths(spline_curve_t* curve) {
+  if (!curve->num_lengths && curve->num_knots) {
+    size_t i;
+    
+    curve->lengths = realloc(curve->lengths, curve->num_knots*
+      sizeof(double));
+    
+    curve->lengths[0] = 0.0;
+    for (i = 1; i < curve->num_knots; ++i)
+      curve->lengths[i] = curve->lengths[i-1]+spline_curve_integrate_speed(
+        curve, i-1, curve->x[i-1], curve->x[i]);
+    
+    curve->num_lengths = curve->num_knots;
+  }
+  
+  return curve->lengths;
+}
+
+double spline_curve_eval_speed(const spline_curve_t* curve, size_t index,
+    double x) {
+  double h = curve->x[index+1]-curve->x[index];
+  double u = (curve->x[index+1]-x)/h;
+  double v = (x-curve->x[index])/h;
+  double w_y2_0 = -(3.0*u*u-1.0)*h/6.0;
+  double w_y2_1 = (3.0*v*v-1.0)*h/6.0;
+  double speed = 0.0;
+  size_t k;
+  
+  for (k = 0; k < curve->num_channels; ++k) {
+    const double* y = &curve->y[k*curve->capacity+index];
+    const double* y2 = &curve->y2[k*curve->capacity+index];
+    double y1 = (y[1]-y[0])/h+w_y2_0*y2[0]+w_y2_1*y2[1];
+    
+    speed += y1*y1;
+  }
+  
+  return sqrt(speed);
+}
+
+double spline_curve_integrate_speed(const spline_curve_t* curve, size_t
+    index, double a, double b) {
+  double r = 0.5*(b-a)/SPLINE_CURVE_QUADRATURE_PANELS;
+  double length = 0.0;
+  size_t i, j;
+  
+  for (j = 0; j < SPLINE_CURVE_QUADRATURE_PANELS; ++j) {
+    double c = a+(2*j+1)*r;
+    
+    for (i = 0; i < sizeof(spline_curve_gauss_legendre_nodes)/
+        sizeof(double); ++i)
+      length += spline_curve_gauss_legendre_weights[i]*
+        spline_curve_eval_speed(curve, index,
+        c+r*spline_curve_gauss_legendre_nodes[i]);
+  }
+  
+  return r*length;
+}
+
+double spline_curve_get_length(spline_curve_t* curve) {
+  error_clear(&curve->error);
+  
+  if (curve->num_knots)
+    return spline_curve_update_lengths(curve)[curve->num_knots-1];
+  else
+    return 0.0;
+}
+
+double spline_curve_eval_length(spline_curve_t* curve, double x) {
+  ssize_t i;
+  
+  if ((i = spline_curve_find_segment(curve, x)) >= 0)
+    return spline_curve_update_lengths(curve)[i]+
+      spline_curve_integrate_speed(curve, i, curve->x[i], x);
+  else
+    return NAN;
+}
+
+double spline_curve_find_length(spline_curve_t* curve, double s) {
+  error_clear(&curve->error);
+  
+  if (curve->num_knots > 1) {
+    const double* lengths = spline_curve_update_lengths(curve);
+    size_t i = 0, j = curve->num_knots-1;
+    
+    if ((s >= 0.0) && (s <= lengths[j])) {
+      while (j-i > 1) {
+        size_t k = (i+j) >> 1;
+        if (lengths[k] > s)
+          j = k;
+        else
+          i = k;
+      }
+      
+      double x_min = curve->x[i], x_max = curve->x[i+1];
+      double x = x_min+(s-lengths[i])/(lengths[i+1]-lengths[i])*
+        (x_max-x_min);
+      double tolerance = 1e-12*(lengths[curve->num_knots-1]+1.0);
+      size_t k;
+      
+      if (!(x >= x_min) || !(x <= x_max))
+        x = 0.5*(x_min+x_max);
+      
+      for (k = 0; k < SPLINE_CURVE_MAX_ITERATIONS; ++k) {
+        double f = lengths[i]+spline_curve_integrate_speed(curve, i,
+          curve->x[i], x)-s;
+        
+        if (fabs(f) <= tolerance)
+          break;
+        else if (f > 0.0)
+          x_max = x;
+        else
+          x_min = x;
+        
+        double speed = spline_curve_eval_speed(curve, i, x);
+        x = (speed > 0.0) ? x-f/speed : x_min-1.0;
+        if (!(x > x_min) || !(x < x_max))
+          x = 0.5*(x_min+x_max);
+      }
+      
+      return x;
+    }
+  }
+  
+  error_setf(&curve->error, SPLINE_ERROR_UNDEFINED, "%lg", s);
+  return NAN;
+}
+
+int spline_curve_eval_point(spline_curve_t* curve, spline_eval_type_t
+    eval_type, double x, transform_point_t* point) {
+  double values[SPLINE_CURVE_POINT_CHANNELS];
+  
+  if (curve->num_channels == SPLINE_CURVE_POINT_CHANNELS) {
+    if (!spline_curve_eval(curve, eval_type, x, values))
+      transform_point_init(point, values[0], values[1], values[2]);
+  }
+  else
+    error_setf(&curve->error, SPLINE_ERROR_CHANNELS, "%d",
+      (int)curve->num_channels);
+  
+  return curve->error.code;
+}
+
+int spline_curve_eval_pose(spline_curve_t* curve, spline_eval_type_t
+    eval_type, double x, transform_pose_t* pose) {
+  double values[SPLINE_CURVE_POSE_CHANNELS];
+  
+  if (curve->num_channels == SPLINE_CURVE_POSE_CHANNELS) {
+    if (!spline_curve_eval(curve, eval_type, x, values))
+      transform_pose_init(pose, values[0], values[1], values[2], values[3],
+        values[4], values[5]);
+  }
+  else
+    error_setf(&curve->error, SPLINE_ERROR_CHANNELS, "%d",
+      (int)curve->num_channels);
+  
+  return curve->error.code;
+}
@@ -0,0 +1,332 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_CURVE_H
+#define SPLINE_CURVE_H
+
+/** \file spline/curve.h
+  * \ingroup spline
+  * \brief Parametric cubic spline curves
+  * \author Ralf Kaestner
+  * 
+  * A spline curve is a vector-valued cubic spline y(x) = (y_1(x), ...,
+  * y_K(x))^T whose K channels share a common sequence of knot locations,
+  * such as the coordinates of a trajectory parameterized over time. The
+  * interface facilitates interpolation and evaluation of all channels at
+  * once and converts to and from the points and poses of the transform
+  * module.
+  */
+
+#include "spline/spline.h"
+
+#include "transform/point.h"
+#include "transform/pose.h"
+
+/** \brief The number of spline curve channels of a point
+  */
+#define SPLINE_CURVE_POINT_CHANNELS           3
+
+/** \brief The number of spline curve channels of a pose
+  */
+#define SPLINE_CURVE_POSE_CHANNELS            6
+
+/** \brief The number of spline curve channels of a spline's graph
+  */
+#define SPLINE_CURVE_GRAPH_CHANNELS           2
+
+/** \brief The number of quadrature panels per spline curve segment
+  * 
+  * Since the norm of a curve's first derivative is not polynomial, the
+  * arc length of a segment is integrated piecewise over the given number
+  * of sub-intervals of equal width.
+  */
+#define SPLINE_CURVE_QUADRATURE_PANELS        4
+
+/** \brief The maximum number of iterations of the arc length inversion
+  */
+#define SPLINE_CURVE_MAX_ITERATIONS           64
+
+/** \brief Structure defining the spline curve
+  * 
+  * The knot values and second derivatives of the curve are stored
+  * channel by channel, each channel occupying a contiguous array of
+  * the curve's capacity. Since the channels share the knot locations,
+  * they also share the tridiagonal matrix of the interpolation problem.
+  * This matrix is factored once, and the channels are then solved as
+  * multiple right-hand sides. Similarly, a single segment lookup by means
+  * of the curve's lookup index serves the evaluation of all channels.
+  * The lookup index is built lazily upon evaluation, as for the spline.
+  * 
+  * For reparameterization by arc length, the curve further maintains a
+  * table of cumulative arc lengths at its knots. The table is built
+  * lazily upon the first arc length query.
+  */
+typedef struct spline_curve_t {
+  double* x;                    //!< The locations of the curve knots.
+  double* y;                    //!< The channel values at the curve knots.
+  double* y2;                   //!< The channel second derivatives.
+  size_t num_knots;             //!< The number of curve knots.
+  size_t num_channels;          //!< The number of channels of the curve.
+  size_t capacity;              //!< The number of allocated curve knots.
+  
+  size_t* index;                //!< The segment lookup index of the curve.
+  size_t num_buckets;           //!< The number of valid index buckets.
+  double bucket_scale;          //!< The inverse width of the buckets.
+  
+  double* lengths;              //!< The cumulative arc lengths at the knots.
+  size_t num_lengths;           //!< The number of valid arc lengths.
+  
+  spline_workspace_t workspace; //!< The interpolation workspace.
+  
+  error_t error;                //!< The most recent spline curve error.
+} spline_curve_t;
+
+/** \brief Initialize an empty spline curve
+  * \param[in] curve The spline curve to be initialized.
+  * \param[in] num_channels The number of channels of the spline curve.
+  */
+void spline_curve_init(
+  spline_curve_t* curve,
+  size_t num_channels);
+
+/** \brief Destroy a spline curve
+  * \param[in] curve The spline curve to be destroyed.
+  */
+void spline_curve_destroy(
+  spline_curve_t* curve);
+
+/** \brief Clear a spline curve
+  * \param[in] curve The spline curve to be cleared.
+  */
+void spline_curve_clear(
+  spline_curve_t* curve);
+
+/** \brief Natural cubic spline curve interpolation from data points
+  * \param[in,out] curve The spline curve to be generated from the data.
+  * \param[in] x An array containing the strictly increasing locations of
+  *   the data points.
+  * \param[in] y An array containing the values of the data points, channel
+  *   by channel, such that the value of channel k at point i is found at
+  *   y[k*num_points+i].
+  * \param[in] num_points The number of data points.
+  * \return The number of knots in the resulting spline curve or the
+  *   negative error code.
+  * 
+  * Each channel of the resulting curve is the natural cubic spline through
+  * its data points as computed by spline_int_natural(). The tridiagonal
+  * system is however factored only once for all channels.
+  */
+ssize_t spline_curve_int_natural(
+  spline_curve_t* curve,
+  const double* x,
+  const double* y,
+  size_t num_points);
+
+/** \brief Periodic cubic spline curve interpolation from data points
+  * \param[in,out] curve The spline curve to be generated from the data.
+  * \param[in] x An array containing the strictly increasing locations of
+  *   the data points.
+  * \param[in] y An array containing the values of the data points, channel
+  *   by channel, such that the value of channel k at point i is found at
+  *   y[k*num_points+i].
+  * \param[in] num_points The number of data points.
+  * \return The number of knots in the resulting spline curve or the
+  *   negative error code.
+  * 
+  * Each channel of the resulting curve is the periodic cubic spline through
+  * its data points as computed by spline_int_periodic(). The symmetric
+  * cyclic tridiagonal system is however factored only once for all
+  * channels.
+  */
+ssize_t spline_curve_int_periodic(
+  spline_curve_t* curve,
+  const double* x,
+  const double* y,
+  size_t num_points);
+
+/** \brief Cubic spline curve interpolation from points
+  * \param[in,out] curve The spline curve to be generated from the points.
+  *   The curve must have SPLINE_CURVE_POINT_CHANNELS channels.
+  * \param[in] x An array containing the strictly increasing locations of
+  *   the points.
+  * \param[in] points An array containing the points to be interpolated.
+  * \param[in] num_points The number of points.
+  * \param[in] periodic If non-zero, periodic interpolation will be
+  *   performed instead of natural interpolation.
+  * \return The number of knots in the resulting spline curve or the
+  *   negative error code.
+  * 
+  * The x, y, and z-components of the points define the curve's channels
+  * in that order.
+  */
+ssize_t spline_curve_int_points(
+  spline_curve_t* curve,
+  const double* x,
+  const transform_point_t* points,
+  size_t num_points,
+  int periodic);
+
+/** \brief Cubic spline curve interpolation from poses
+  * \param[in,out] curve The spline curve to be generated from the poses.
+  *   The curve must have SPLINE_CURVE_POSE_CHANNELS channels.
+  * \param[in] x An array containing the strictly increasing locations of
+  *   the poses.
+  * \param[in] poses An array containing the poses to be interpolated.
+  * \param[in] num_poses The number of poses.
+  * \param[in] periodic If non-zero, periodic interpolation will be
+  *   performed instead of natural interpolation.
+  * \return The number of knots in the resulting spline curve or the
+  *   negative error code.
+  * 
+  * The x, y, and z-components followed by the yaw, pitch, and roll angles
+  * of the poses define the curve's channels in that order. Note that the
+  * angles are interpolated as they are, such that any discontinuities
+  * must be unwrapped by the caller.
+  */
+ssize_t spline_curve_int_poses(
+  spline_curve_t* curve,
+  const double* x,
+  const transform_pose_t* poses,
+  size_t num_poses,
+  int periodic);
+
+/** \brief Set the spline curve to the graph of a cubic spline
+  * \param[in,out] curve The spline curve to be set to the graph of the
+  *   cubic spline. The curve must have SPLINE_CURVE_GRAPH_CHANNELS
+  *   channels.
+  * \param[in] spline The cubic spline whose graph defines the curve.
+  * \return The number of knots in the resulting spline curve or the
+  *   negative error code.
+  * 
+  * The curve's first channel will be the identity x, the second channel
+  * the cubic spline f(x), such that the curve traces the points (x, f(x))
+  * of the spline's graph. This allows for stepping along the graph at
+  * equidistant arc lengths.
+  */
+ssize_t spline_curve_graph(
+  spline_curve_t* curve,
+  const spline_t* spline);
+
+/** \brief Find segment of the spline curve at a given location
+  * \param[in] curve The spline curve to be searched for the segment.
+  * \param[in] x The location to find the spline curve segment for.
+  * \return The index of the spline curve segment at the given location
+  *   or the negative error code if no such segment exists.
+  * 
+  * This function searches the curve by means of its segment lookup index,
+  * which is built if necessary. See spline_find_segment() for details.
+  */
+ssize_t spline_curve_find_segment(
+  spline_curve_t* curve,
+  double x);
+
+/** \brief Evaluate the spline curve at a given location
+  * \param[in] curve The spline curve to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the spline curve.
+  * \param[out] values An array receiving the values of the curve's
+  *   channels at the given location. If the curve is undefined at the
+  *   given location, the values will be set to NaN.
+  * \return The resulting error code.
+  * 
+  * The segment containing the location is identified once by
+  * spline_curve_find_segment(). The weights of the segment's knot values
+  * and second derivatives then depend on the location only, such that
+  * each channel is evaluated by four multiplications.
+  */
+int spline_curve_eval(
+  spline_curve_t* curve,
+  spline_eval_type_t eval_type,
+  double x,
+  double* values);
+
+/** \brief Retrieve the arc length of the spline curve
+  * \param[in] curve The spline curve to retrieve the arc length for.
+  * \return The total arc length of the spline curve.
+  * 
+  * The arc length is retrieved from the curve's table of cumulative arc
+  * lengths, which is built if necessary. The table integrates the norm
+  * of the curve's first derivative over each segment by means of 5-point
+  * Gauss-Legendre quadrature on SPLINE_CURVE_QUADRATURE_PANELS panels.
+  */
+double spline_curve_get_length(
+  spline_curve_t* curve);
+
+/** \brief Evaluate the arc length of the spline curve at a given location
+  * \param[in] curve The spline curve to be evaluated.
+  * \param[in] x The location at which to evaluate the arc length.
+  * \return The arc length of the spline curve from its first knot to the
+  *   given location or NaN if the curve is undefined at that location.
+  * 
+  * The arc length is found from the curve's table of cumulative arc
+  * lengths and the quadrature of the segment containing the location.
+  */
+double spline_curve_eval_length(
+  spline_curve_t* curve,
+  double x);
+
+/** \brief Find the location of the spline curve at a given arc length
+  * \param[in] curve The spline curve to be searched for the location.
+  * \param[in] s The arc length from the curve's first knot.
+  * \return The location of the spline curve at the given arc length or
+  *   NaN if the arc length exceeds the range of the curve.
+  * 
+  * This function inverts spline_curve_eval_length(). The segment holding
+  * the arc length is found by bisection of the curve's table of
+  * cumulative arc lengths. Within this segment, the location is refined
+  * by Newton's method, falling back to bisection whenever an iteration
+  * leaves the segment. Thus, the curve may be evaluated at equidistant
+  * arc lengths without integrating it from its first knot for each step.
+  */
+double spline_curve_find_length(
+  spline_curve_t* curve,
+  double s);
+
+/** \brief Evaluate the spline curve as a point at a given location
+  * \param[in] curve The spline curve to be evaluated. The curve must
+  *   have SPLINE_CURVE_POINT_CHANNELS channels.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the spline curve.
+  * \param[out] point The point receiving the values of the curve's
+  *   channels at the given location.
+  * \return The resulting error code.
+  */
+int spline_curve_eval_point(
+  spline_curve_t* curve,
+  spline_eval_type_t eval_type,
+  double x,
+  transform_point_t* point);
+
+/** \brief Evaluate the spline curve as a pose at a given location
+  * \param[in] curve The spline curve to be evaluated. The curve must
+  *   have SPLINE_CURVE_POSE_CHANNELS channels.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the spline curve.
+  * \param[out] pose The pose receiving the values of the curve's
+  *   channels at the given location.
+  * \return The resulting error code.
+  */
+int spline_curve_eval_pose(
+  spline_curve_t* curve,
+  spline_eval_type_t eval_type,
+  double x,
+  transform_pose_t* pose);
+
+#endif
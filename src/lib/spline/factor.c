@@ -0,0 +1,392 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "factor.h"
+
+#include "spline/tridiag.h"
+
+#define sqr(a) ((a)*(a))
+
+void spline_factor_init_rows(const double* x, size_t num_points, double* c,
+  double* d, double* e);
+void spline_factor_init_rhs(const spline_factor_t* factor, const double* y,
+  double* b);
+int spline_factor_init_knots(const spline_factor_t* factor, const double* y,
+  const double* b, spline_t* spline);
+
+void spline_factor_init(spline_factor_t* factor) {
+  factor->type = spline_int_type_natural;
+  factor->x = 0;
+  factor->num_points = 0;
+  factor->size = 0;
+  
+  factor->y1_0 = 0.0;
+  factor->y1_n = 0.0;
+  factor->y2_0 = 0.0;
+  factor->y2_n = 0.0;
+  factor->r_0 = 0.5;
+  factor->r_n = 0.5;
+  
+  spline_workspace_init(&factor->workspace);
+  factor->b = 0;
+  factor->rhs_size = 0;
+  
+  error_init(&factor->error, spline_errors);
+}
+
+void spline_factor_destroy(spline_factor_t* factor) {
+  if (factor->x)
+    free(factor->x);
+  if (factor->b)
+    free(factor->b);
+  
+  spline_workspace_destroy(&factor->workspace);
+  error_destroy(&factor->error);
+  
+  factor->x = 0;
+  factor->num_points = 0;
+  factor->size = 0;
+  factor->b = 0;
+  factor->rhs_size = 0;
+}
+
+int spline_factor_compute(spline_factor_t* factor, spline_int_type_t type,
+    const double* x, size_t num_points) {
+  error_clear(&factor->error);
+  
+  factor->type = type;
+  factor->size = 0;
+  
+  if ((num_points < 3) || ((num_points < 5) &&
+      ((type == spline_int_type_y1_y2) ||
+      (type == spline_int_type_not_a_knot)))) {
+    error_set(&factor->error, SPLINE_ERROR_INTERPOLATION);
+    return factor->error.code;
+  }
+  
+  if (num_points > factor->num_points)
+    factor->x = realloc(factor->x, num_points*sizeof(double));
+  memcpy(factor->x, x, num_points*sizeof(double));
+  factor->num_points = num_points;
+  
+  size_t n = num_points, m = n;
+  if (type == spline_int_type_periodic)
+    m = n-1;
+  else if (type == spline_int_type_not_a_knot)
+    m = n-2;
+  
+  spline_workspace_t* workspace = &factor->workspace;
+  if (spline_workspace_reserve(workspace, m) < m) {
+    error_set(&factor->error, SPLINE_ERROR_INTERPOLATION);
+    return factor->error.code;
+  }
+  
+  double* c = workspace->c;
+  double* d = workspace->d;
+  double* e = workspace->e;
+  int result;
+  
+  switch (type) {
+    case spline_int_type_y1:
+    case spline_int_type_clamped:
+      spline_factor_init_rows(x, n, c, d, e);
+      d[0] = 2.0;
+      e[0] = 1.0;
+      c[n-2] = 1.0;
+      d[n-1] = 2.0;
+      break;
+    case spline_int_type_y2:
+    case spline_int_type_natural:
+      spline_factor_init_rows(x, n, c, d, e);
+      d[0] = 1.0;
+      e[0] = 0.0;
+      c[n-2] = 0.0;
+      d[n-1] = 1.0;
+      break;
+    case spline_int_type_y1_y2: {
+      double h_1 = factor->r_0*(x[1]-x[0]);
+      double h_2 = (1.0-factor->r_0)*(x[1]-x[0]);
+      double h_3 = x[2]-x[1];
+      double h_l = x[n-2]-x[n-3];
+      double h_m = (1.0-factor->r_n)*(x[n-1]-x[n-2]);
+      double h_n = factor->r_n*(x[n-1]-x[n-2]);
+      
+      spline_factor_init_rows(x, n, c, d, e);
+      d[0] = 2.0*h_2+h_1*(3.0+h_1/h_2);
+      e[0] = h_2;
+      c[0] = h_2-sqr(h_1)/h_2;
+      d[1] = 2.0*(h_2+h_3);
+      c[n-3] = h_l;
+      d[n-2] = 2.0*(h_l+h_m);
+      e[n-2] = h_m-sqr(h_n)/h_m;
+      c[n-2] = h_m;
+      d[n-1] = 2.0*h_m+h_n*(3.0+h_n/h_m);
+      break;
+    }
+    case spline_int_type_periodic: {
+      double h_1 = x[1]-x[0];
+      double h_m = x[n-1]-x[n-2];
+      
+      spline_factor_init_rows(x, n, c, d, e);
+      memmove(e, c, (n-2)*sizeof(double));
+      d[0] = 2.0*(h_1+h_m);
+      e[n-2] = h_m;
+      break;
+    }
+    case spline_int_type_not_a_knot: {
+      double h_1 = x[1]-x[0];
+      double h_2 = x[2]-x[1];
+      double h_m = x[n-2]-x[n-3];
+      double h_n = x[n-1]-x[n-2];
+      
+      spline_factor_init_rows(&x[1], m, c, d, e);
+      d[0] = 3.0*h_1+2.0*h_2+sqr(h_1)/h_2;
+      e[0] = h_2-sqr(h_1)/h_2;
+      c[m-2] = h_m-sqr(h_n)/h_m;
+      d[m-1] = 3.0*h_n+2.0*h_m+sqr(h_n)/h_m;
+      break;
+    }
+  }
+  
+  if (type == spline_int_type_periodic)
+    result = spline_tridiag_factor_symm_cyc(d, e, workspace->w,
+      workspace->m, workspace->z, m);
+  else
+    result = spline_tridiag_factor(c, d, e, workspace->w, workspace->m, m);
+  
+  if (!result)
+    factor->size = m;
+  else
+    error_set(&factor->error, result);
+  
+  return factor->error.code;
+}
+
+ssize_t spline_factor_solve(spline_factor_t* factor, const double* y,
+    spline_t* spline) {
+  return spline_factor_solve_batch(factor, y, 1, spline);
+}
+
+ssize_t spline_factor_solve_batch(spline_factor_t* factor, const double* y,
+    size_t num_sequences, spline_t* splines) {
+  spline_workspace_t* workspace = &factor->workspace;
+  size_t m = factor->size;
+  size_t k;
+  
+  error_clear(&factor->error);
+  
+  if (!m) {
+    error_set(&factor->error, SPLINE_ERROR_INTERPOLATION);
+    return -factor->error.code;
+  }
+  
+  if (num_sequences*m > factor->rhs_size) {
+    size_t rhs_size = 2*factor->rhs_size;
+    if (rhs_size < num_sequences*m)
+      rhs_size = num_sequences*m;
+    
+    factor->b = realloc(factor->b, rhs_size*sizeof(double));
+    factor->rhs_size = rhs_size;
+  }
+  
+  for (k = 0; k < num_sequences; ++k)
+    spline_factor_init_rhs(factor, &y[k*factor->num_points],
+      &factor->b[k*m]);
+  
+  if (factor->type == spline_int_type_periodic)
+    spline_tridiag_solve_factor_symm_cyc(workspace->d, workspace->e,
+      workspace->w, workspace->m, workspace->z, factor->b, m, num_sequences,
+      m);
+  else
+    spline_tridiag_solve_factor(workspace->c, workspace->w, workspace->m,
+      factor->b, m, num_sequences, m);
+  
+  for (k = 0; k < num_sequences; ++k) {
+    error_clear(&splines[k].error);
+    if (spline_factor_init_knots(factor, &y[k*factor->num_points],
+        &factor->b[k*m], &splines[k])) {
+      error_set(&splines[k].error, SPLINE_ERROR_INTERPOLATION);
+      error_set(&factor->error, SPLINE_ERROR_INTERPOLATION);
+    }
+  }
+  
+  if (factor->error.code)
+    return -factor->error.code;
+  
+  return num_sequences ? splines[0].num_knots : 0;
+}
+
+void spline_factor_init_rows(const double* x, size_t num_points, double* c,
+    double* d, double* e) {
+  size_t i;
+  double h_i, h_j = 0.0;
+  
+  for (i = 1; i < num_points-1; ++i) {
+    h_i = (i > 1) ? h_j : x[i]-x[i-1];
+    h_j = x[i+1]-x[i];
+    
+    c[i-1] = h_i;
+    d[i] = 2.0*(h_i+h_j);
+    e[i] = h_j;
+  }
+}
+
+void spline_factor_init_rhs(const spline_factor_t* factor, const double* y,
+    double* b) {
+  const double* x = factor->x;
+  size_t n = factor->num_points;
+  size_t i;
+  
+  if (factor->type == spline_int_type_not_a_knot) {
+    ++x;
+    ++y;
+    n -= 2;
+  }
+  
+  double h_i, h_j = 0.0;
+  for (i = 1; i < n-1; ++i) {
+    h_i = (i > 1) ? h_j : x[i]-x[i-1];
+    h_j = x[i+1]-x[i];
+    
+    b[i] = 6.0*((y[i+1]-y[i])/h_j-(y[i]-y[i-1])/h_i);
+  }
+  
+  switch (factor->type) {
+    case spline_int_type_y1:
+    case spline_int_type_clamped: {
+      int clamped = (factor->type == spline_int_type_clamped);
+      double y1_0 = clamped ? 0.0 : factor->y1_0;
+      double y1_n = clamped ? 0.0 : factor->y1_n;
+      double h_1 = x[1]-x[0];
+      double h_n = x[n-1]-x[n-2];
+      
+      b[0] = 6.0/h_1*((y[1]-y[0])/h_1-y1_0);
+      b[n-1] = 6.0/h_n*(y1_n-(y[n-1]-y[n-2])/h_n);
+      break;
+    }
+    case spline_int_type_y2:
+      b[0] = factor->y2_0;
+      b[n-1] = factor->y2_n;
+      break;
+    case spline_int_type_natural:
+      b[0] = 0.0;
+      b[n-1] = 0.0;
+      break;
+    case spline_int_type_y1_y2: {
+      double y1_0 = factor->y1_0, y1_n = factor->y1_n;
+      double y2_0 = factor->y2_0, y2_n = factor->y2_n;
+      double h_1 = factor->r_0*(x[1]-x[0]);
+      double h_2 = (1.0-factor->r_0)*(x[1]-x[0]);
+      double h_3 = x[2]-x[1];
+      double h_l = x[n-2]-x[n-3];
+      double h_m = (1.0-factor->r_n)*(x[n-1]-x[n-2]);
+      double h_n = factor->r_n*(x[n-1]-x[n-2]);
+      
+      b[0] = 6.0*((y[1]-y[0])/h_2-y1_0*(1.0+h_1/h_2)-
+        y2_0*(0.5+h_1/(3.0*h_2))*h_1);
+      b[1] = 6.0*((y[2]-y[1])/h_3-(y[1]-y[0])/h_2+y1_0*h_1/h_2+
+        y2_0*sqr(h_1)/(3.0*h_2));
+      b[n-2] = 6.0*((y[n-1]-y[n-2])/h_m-(y[n-2]-y[n-3])/h_l-
+        y1_n*h_n/h_m+y2_n*sqr(h_n)/(3.0*h_m));
+      b[n-1] = 6.0*((y[n-2]-y[n-1])/h_m+y1_n*(1.0+h_n/h_m)-
+        y2_n*(0.5+h_n/(3.0*h_m))*h_n);
+      break;
+    }
+    case spline_int_type_periodic: {
+      double h_1 = x[1]-x[0];
+      double h_m = x[n-1]-x[n-2];
+      
+      b[0] = 6.0*((y[1]-y[0])/h_1-(y[n-1]-y[n-2])/h_m);
+      break;
+    }
+    case spline_int_type_not_a_knot: {
+      double h_1 = x[0]-x[-1];
+      double h_n = x[n]-x[n-1];
+      
+      b[0] = 6.0*((y[1]-y[0])/(x[1]-x[0])-(y[0]-y[-1])/h_1);
+      b[n-1] = 6.0*((y[n]-y[n-1])/h_n-(y[n-1]-y[n-2])/(x[n-1]-x[n-2]));
+      break;
+    }
+  }
+}
+
+int spline_factor_init_knots(const spline_factor_t* factor, const double* y,
+    const double* b, spline_t* spline) {
+  const double* x = factor->x;
+  size_t n = factor->num_points;
+  size_t num_knots = n;
+  size_t i;
+  
+  if (factor->type == spline_int_type_y1_y2)
+    num_knots = n+2;
+  else if (factor->type == spline_int_type_not_a_knot)
+    num_knots = n-2;
+  
+  if (spline_reserve_knots(spline, num_knots) < num_knots)
+    return SPLINE_ERROR_INTERPOLATION;
+  spline->num_knots = num_knots;
+  
+  switch (factor->type) {
+    case spline_int_type_y1_y2: {
+      double h_1 = factor->r_0*(x[1]-x[0]);
+      double h_n = factor->r_n*(x[n-1]-x[n-2]);
+      
+      spline_knot_init(&spline->knots[0], x[0], y[0], factor->y2_0);
+      spline_knot_init(&spline->knots[1], x[0]+h_1, (factor->y2_0/3.0*h_1+
+        b[0]/6.0*h_1+factor->y1_0)*h_1+y[0], b[0]);
+      for (i = 1; i < n-1; ++i)
+        spline_knot_init(&spline->knots[i+1], x[i], y[i], b[i]);
+      spline_knot_init(&spline->knots[n], x[n-1]-h_n, (factor->y2_n/3.0*h_n+
+        b[n-1]/6.0*h_n-factor->y1_n)*h_n+y[n-1], b[n-1]);
+      spline_knot_init(&spline->knots[n+1], x[n-1], y[n-1], factor->y2_n);
+      break;
+    }
+    case spline_int_type_periodic:
+      for (i = 0; i < n; ++i)
+        spline_knot_init(&spline->knots[i], x[i], y[i], b[(i+1 < n) ? i : 0]);
+      break;
+    case spline_int_type_not_a_knot: {
+      for (i = 0; i < n-2; ++i)
+        spline_knot_init(&spline->knots[i], x[i+1], y[i+1], b[i]);
+      
+      spline_knot_t* knot_1 = &spline->knots[0];
+      knot_1->y2 = spline_knot_eval(&spline->knots[0], &spline->knots[1],
+        spline_eval_type_second_derivative, x[0]);
+      knot_1->x = x[0];
+      knot_1->y = y[0];
+      
+      spline_knot_t* knot_n = &spline->knots[n-3];
+      knot_n->y2 = spline_knot_eval(&spline->knots[n-4], &spline->knots[n-3],
+        spline_eval_type_second_derivative, x[n-1]);
+      knot_n->x = x[n-1];
+      knot_n->y = y[n-1];
+      break;
+    }
+    default:
+      for (i = 0; i < n; ++i)
+        spline_knot_init(&spline->knots[i], x[i], y[i], b[i]);
+  }
+  
+  spline_invalidate(spline);
+  
+  return 0;
+}
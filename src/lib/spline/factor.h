@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_FACTOR_H
+#define SPLINE_FACTOR_H
+
+/** \file spline/factor.h
+  * \ingroup spline
+  * \brief Factored cubic spline interpolation
+  * \author Ralf Kaestner
+  * 
+  * The system of equations arising in cubic spline interpolation depends
+  * on the locations of the data points and the type of boundary
+  * conditions only, whereas the values of the data points enter its
+  * right-hand side. A spline factor holds the factorization of this
+  * system for a fixed sequence of locations, such that splines for any
+  * number of value sequences may be interpolated by substitution alone.
+  */
+
+#include "spline/spline.h"
+#include "spline/int_type.h"
+
+/** \brief Structure defining the spline factor
+  * 
+  * In addition to the factored system, the spline factor carries the
+  * boundary conditions applied by the interpolation types involving known
+  * derivatives. The derivatives default to zero and may be modified
+  * directly between solves. The ratios locating the intermediate knots
+  * of the spline_int_type_y1_y2 interpolation type default to 0.5 and
+  * must be modified before the factorization, since they enter the
+  * system's matrix.
+  */
+typedef struct spline_factor_t {
+  spline_int_type_t type;       //!< The interpolation type of the factor.
+  double* x;                    //!< The locations of the data points.
+  size_t num_points;            //!< The number of data points.
+  size_t size;                  //!< The size of the factored system.
+  
+  double y1_0;                  //!< The first derivative at the first knot.
+  double y1_n;                  //!< The first derivative at the last knot.
+  double y2_0;                  //!< The second derivative at the first knot.
+  double y2_n;                  //!< The second derivative at the last knot.
+  double r_0;                   //!< The ratio of the first intermediate knot.
+  double r_n;                   //!< The ratio of the last intermediate knot.
+  
+  spline_workspace_t workspace; //!< The factored system.
+  double* b;                    //!< The right-hand sides of the system.
+  size_t rhs_size;              //!< The allocated size of the right-hand sides.
+  
+  error_t error;                //!< The most recent spline factor error.
+} spline_factor_t;
+
+/** \brief Initialize an empty spline factor
+  * \param[in] factor The spline factor to be initialized.
+  */
+void spline_factor_init(
+  spline_factor_t* factor);
+
+/** \brief Destroy a spline factor
+  * \param[in] factor The spline factor to be destroyed.
+  */
+void spline_factor_destroy(
+  spline_factor_t* factor);
+
+/** \brief Factor the cubic spline interpolation problem for a sequence of
+  *   locations
+  * \param[in,out] factor The spline factor holding the factorization.
+  * \param[in] type The interpolation type defining the boundary
+  *   conditions of the interpolation problem.
+  * \param[in] x An array containing the strictly increasing locations of
+  *   the data points to be interpolated.
+  * \param[in] num_points The number of data points.
+  * \return The resulting error code.
+  * 
+  * This function sets up the matrix of the tridiagonal or, for the
+  * periodic interpolation type, the symmetric cyclic tridiagonal system
+  * of the interpolation problem and performs its elimination pass in
+  * O(N) computational time. The locations are copied into the factor.
+  */
+int spline_factor_compute(
+  spline_factor_t* factor,
+  spline_int_type_t type,
+  const double* x,
+  size_t num_points);
+
+/** \brief Cubic spline interpolation from factored data points
+  * \param[in] factor The spline factor of the interpolation problem.
+  * \param[in] y An array containing the values of the data points at the
+  *   factored locations.
+  * \param[in,out] spline The cubic spline to be generated from the data.
+  * \return The number of knots in the resulting cubic spline or the
+  *   negative error code.
+  * 
+  * The resulting spline equals the spline obtained from the interpolation
+  * function corresponding to the factor's interpolation type, e.g.,
+  * spline_int_not_a_knot(). Its second derivatives are however computed
+  * by forward and backward substitution only.
+  */
+ssize_t spline_factor_solve(
+  spline_factor_t* factor,
+  const double* y,
+  spline_t* spline);
+
+/** \brief Cubic spline interpolation from multiple sequences of factored
+  *   data points
+  * \param[in] factor The spline factor of the interpolation problem.
+  * \param[in] y An array containing the values of the data points at the
+  *   factored locations, sequence by sequence, such that the value of
+  *   sequence k at location i is found at y[k*N+i] for N data points.
+  * \param[in] num_sequences The number of sequences of values.
+  * \param[in,out] splines An array of cubic splines to be generated from
+  *   the data, one for each sequence of values.
+  * \return The number of knots in each resulting cubic spline or the
+  *   negative error code.
+  * 
+  * The right-hand sides of all sequences are substituted simultaneously,
+  * such that each element of the factorization is loaded once for all
+  * of them.
+  */
+ssize_t spline_factor_solve_batch(
+  spline_factor_t* factor,
+  const double* y,
+  size_t num_sequences,
+  spline_t* splines);
+
+#endif
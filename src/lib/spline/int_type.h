@@ -0,0 +1,45 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_INT_TYPE_H
+#define SPLINE_INT_TYPE_H
+
+/** \file spline/int_type.h
+  * \ingroup spline
+  * \brief Definition of the spline interpolation type
+  * \author Ralf Kaestner
+  * 
+  * The spline interpolation type determines the boundary conditions
+  * imposed on a cubic spline interpolating a sequence of data points.
+  */
+
+/** \brief Spline interpolation type
+  */
+typedef enum {
+  spline_int_type_y1,                   //!< Known first derivatives.
+  spline_int_type_y2,                   //!< Known second derivatives.
+  spline_int_type_y1_y2,                //!< Known first and second derivatives.
+  spline_int_type_natural,              //!< Zero second derivatives.
+  spline_int_type_clamped,              //!< Zero first derivatives.
+  spline_int_type_periodic,             //!< Equal first and second derivatives.
+  spline_int_type_not_a_knot,           //!< No additional conditions.
+} spline_int_type_t;
+
+#endif
@@ -18,12 +18,18 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <math.h>
+#include <float.h>
+
 #include "segment.h"
 
 #include "spline/spline.h"
 
-#define sqr(a) ((a)*(a))
-#define cub(a) ((a)*(a)*(a))
+void spline_segment_get_poly(const spline_segment_t* segment,
+  spline_eval_type_t eval_type, double* p);
+size_t spline_segment_get_critical(const double* p, double h, double* t);
+double spline_segment_find_root(const double* p, double t_min, double
+  t_max, double f_min);
 
 void spline_segment_init(spline_segment_t* segment, double a, double b,
     double c, double d, double x_0) {
@@ -35,6 +41,19 @@ void spline_segment_init(spline_segment_t* segment, double a, double b,
   segment->x_0 = x_0;
 }
 
+void spline_segment_init_knots(spline_segment_t* segment, const
+    spline_knot_t* knot_min, const spline_knot_t* knot_max) {
+  double h_i = knot_max->x-knot_min->x;
+  
+  segment->a = (knot_max->y2-knot_min->y2)/(6.0*h_i);
+  segment->b = 0.5*knot_min->y2;
+  segment->c = (knot_max->y-knot_min->y)/h_i-
+    (2.0*knot_min->y2+knot_max->y2)*h_i/6.0;
+  segment->d = knot_min->y;
+  
+  segment->x_0 = knot_min->x;
+}
+
 void spline_segment_init_zero(spline_segment_t* segment) {
   segment->a = 0.0;
   segment->b = 0.0;
@@ -67,9 +86,174 @@ double spline_segment_eval(const spline_segment_t* segment, spline_eval_type_t
   x -= segment->x_0;
 
   if (eval_type == spline_eval_type_first_derivative)
-    return 3.0*segment->a*sqr(x)+2.0*segment->b*x+segment->c;
+    return (3.0*segment->a*x+2.0*segment->b)*x+segment->c;
   else if (eval_type == spline_eval_type_second_derivative)
     return 6.0*segment->a*x+2.0*segment->b;
   else
-    return segment->a*cub(x)+segment->b*sqr(x)+segment->c*x+segment->d;
+    return ((segment->a*x+segment->b)*x+segment->c)*x+segment->d;
+}
+
+void spline_segment_eval_derivatives(const spline_segment_t* segment, double
+    x, double* y, double* y1, double* y2) {
+  double a = segment->a, b = segment->b, c = segment->c;
+  x -= segment->x_0;
+  
+  if (y)
+    *y = ((a*x+b)*x+c)*x+segment->d;
+  if (y1)
+    *y1 = (3.0*a*x+2.0*b)*x+c;
+  if (y2)
+    *y2 = 6.0*a*x+2.0*b;
+}
+
+double spline_segment_integrate(const spline_segment_t* segment, double a,
+    double b) {
+  a -= segment->x_0;
+  b -= segment->x_0;
+  
+  return (((0.25*segment->a*b+segment->b/3.0)*b+0.5*segment->c)*b+
+    segment->d)*b-(((0.25*segment->a*a+segment->b/3.0)*a+0.5*segment->c)*
+    a+segment->d)*a;
+}
+
+void spline_segment_get_bounds(const spline_segment_t* segment,
+    spline_eval_type_t eval_type, double x_max, double* min, double* max) {
+  double p[4], t[3];
+  double h = x_max-segment->x_0;
+  size_t i, num_critical;
+  
+  spline_segment_get_poly(segment, eval_type, p);
+  num_critical = spline_segment_get_critical(p, h, t);
+  
+  *min = p[0];
+  *max = p[0];
+  t[num_critical++] = h;
+  
+  for (i = 0; i < num_critical; ++i) {
+    double f = ((p[3]*t[i]+p[2])*t[i]+p[1])*t[i]+p[0];
+    
+    if (f < *min)
+      *min = f;
+    if (f > *max)
+      *max = f;
+  }
+}
+
+size_t spline_segment_solve(const spline_segment_t* segment,
+    spline_eval_type_t eval_type, double y, double x_max, double* x) {
+  double p[4], t[4];
+  double h = x_max-segment->x_0;
+  size_t i, num_critical, num_roots = 0;
+  
+  spline_segment_get_poly(segment, eval_type, p);
+  p[0] -= y;
+  num_critical = spline_segment_get_critical(p, h, &t[1]);
+  
+  t[0] = 0.0;
+  t[num_critical+1] = h;
+  
+  double f_0 = p[0];
+  if (f_0 == 0.0)
+    x[num_roots++] = segment->x_0;
+  
+  for (i = 0; i <= num_critical; ++i) {
+    double t_1 = t[i+1];
+    double f_1 = ((p[3]*t_1+p[2])*t_1+p[1])*t_1+p[0];
+    
+    if (f_1 == 0.0)
+      x[num_roots++] = (i < num_critical) ? segment->x_0+t_1 : x_max;
+    else if ((f_0 != 0.0) && ((f_0 < 0.0) != (f_1 < 0.0)))
+      x[num_roots++] = segment->x_0+
+        spline_segment_find_root(p, t[i], t_1, f_0);
+    
+    f_0 = f_1;
+  }
+  
+  return num_roots;
+}
+
+void spline_segment_get_poly(const spline_segment_t* segment,
+    spline_eval_type_t eval_type, double* p) {
+  if (eval_type == spline_eval_type_first_derivative) {
+    p[3] = 0.0;
+    p[2] = 3.0*segment->a;
+    p[1] = 2.0*segment->b;
+    p[0] = segment->c;
+  }
+  else if (eval_type == spline_eval_type_second_derivative) {
+    p[3] = 0.0;
+    p[2] = 0.0;
+    p[1] = 6.0*segment->a;
+    p[0] = 2.0*segment->b;
+  }
+  else {
+    p[3] = segment->a;
+    p[2] = segment->b;
+    p[1] = segment->c;
+    p[0] = segment->d;
+  }
+}
+
+size_t spline_segment_get_critical(const double* p, double h, double* t) {
+  double a = 3.0*p[3], b = 2.0*p[2], c = p[1];
+  double t_0 = NAN, t_1 = NAN;
+  size_t num_critical = 0;
+  
+  if (a != 0.0) {
+    double disc = b*b-4.0*a*c;
+    
+    if (disc > 0.0) {
+      double q = -0.5*(b+((b < 0.0) ? -sqrt(disc) : sqrt(disc)));
+      
+      t_0 = q/a;
+      if (q != 0.0)
+        t_1 = c/q;
+      if (t_1 < t_0) {
+        double t_swap = t_0;
+        t_0 = t_1;
+        t_1 = t_swap;
+      }
+    }
+  }
+  else if (b != 0.0)
+    t_0 = -c/b;
+  
+  if ((t_0 > 0.0) && (t_0 < h))
+    t[num_critical++] = t_0;
+  if ((t_1 > 0.0) && (t_1 < h))
+    t[num_critical++] = t_1;
+  
+  return num_critical;
+}
+
+double spline_segment_find_root(const double* p, double t_min, double
+    t_max, double f_min) {
+  double f_max = ((p[3]*t_max+p[2])*t_max+p[1])*t_max+p[0];
+  double t = t_min-f_min*(t_max-t_min)/(f_max-f_min);
+  double epsilon = 2.0*DBL_EPSILON*t_max;
+  size_t i;
+  
+  for (i = 0; i < SPLINE_SEGMENT_MAX_ITERATIONS; ++i) {
+    double f = ((p[3]*t+p[2])*t+p[1])*t+p[0];
+    double f1 = (3.0*p[3]*t+2.0*p[2])*t+p[1];
+    
+    if (f == 0.0)
+      break;
+    else if ((f < 0.0) == (f_min < 0.0))
+      t_min = t;
+    else
+      t_max = t;
+    
+    double t_next = t-f/f1;
+    if (!((t_next > t_min) && (t_next < t_max)))
+      t_next = 0.5*(t_min+t_max);
+    
+    if (fabs(t_next-t) <= epsilon) {
+      t = t_next;
+      break;
+    }
+    t = t_next;
+  }
+  
+  return t;
 }
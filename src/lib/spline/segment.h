@@ -33,8 +33,14 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "spline/knot.h"
 #include "spline/eval_type.h"
 
+/** \brief Predefined maximum number of iterations for refining the roots
+  *   of a spline segment
+  */
+#define SPLINE_SEGMENT_MAX_ITERATIONS        64
+
 /** \brief Structure defining a spline segment
   * 
   * A spline segment is defined by the coefficients a, b, c, and d of the
@@ -69,6 +75,22 @@ void spline_segment_init(
   double d,
   double x_0);
 
+/** \brief Initialize spline segment from two cubic spline knots
+  * \param[in] segment The spline segment to be initialized.
+  * \param[in] knot_min The spline knot whose location defines the lower
+  *   bound of the spline segment.
+  * \param[in] knot_max The spline knot whose location defines the upper
+  *   bound of the spline segment.
+  * 
+  * The coefficients of the spline segment are derived from the third-order
+  * polynomial defined by the two knots, with the location of the spline
+  * segment being the location of the lower bound knot.
+  */
+void spline_segment_init_knots(
+  spline_segment_t* segment,
+  const spline_knot_t* knot_min,
+  const spline_knot_t* knot_max);
+
 /** \brief Initialize spline segment with zeros
   * \param[in] segment The spline segment to be initialized with zero
   *   coefficients and location.
@@ -98,10 +120,95 @@ void spline_segment_print(
   * \param[in] eval_type The evaluation type to be used.
   * \param[in] x The location at which to evaluate the spline segment.
   * \return The value of the spline segment at the given location.
+  * 
+  * The third-order polynomial is evaluated in Horner form.
   */
 double spline_segment_eval(
   const spline_segment_t* segment,
   spline_eval_type_t eval_type,
   double x);
 
+/** \brief Evaluate spline segment and its derivatives at a given location
+  * \param[in] segment The spline segment to be evaluated.
+  * \param[in] x The location at which to evaluate the spline segment.
+  * \param[out] y The pointer receiving the value of the spline segment
+  *   at the given location or null if the value is not requested.
+  * \param[out] y1 The pointer receiving the first derivative of the spline
+  *   segment at the given location or null if it is not requested.
+  * \param[out] y2 The pointer receiving the second derivative of the spline
+  *   segment at the given location or null if it is not requested.
+  * 
+  * The requested values are identical to the results of the corresponding
+  * calls to spline_segment_eval(), but share the segment's coefficients
+  * and the offset of the location.
+  */
+void spline_segment_eval_derivatives(
+  const spline_segment_t* segment,
+  double x,
+  double* y,
+  double* y1,
+  double* y2);
+
+/** \brief Integrate spline segment over a given interval
+  * \param[in] segment The spline segment to be integrated.
+  * \param[in] a The lower bound of the interval of integration.
+  * \param[in] b The upper bound of the interval of integration.
+  * \return The definite integral of the spline segment's polynomial from
+  *   a to b.
+  * 
+  * The integral is computed as the difference of the polynomial's
+  * antiderivative at the bounds, each evaluated in Horner form. The
+  * bounds are not required to lie within the spline segment.
+  */
+double spline_segment_integrate(
+  const spline_segment_t* segment,
+  double a,
+  double b);
+
+/** \brief Find the bounds of a spline segment over a given interval
+  * \param[in] segment The spline segment whose bounds will be found.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x_max The upper bound of the interval starting at the
+  *   location of the spline segment.
+  * \param[out] min The pointer receiving the minimum value of the spline
+  *   segment within the interval.
+  * \param[out] max The pointer receiving the maximum value of the spline
+  *   segment within the interval.
+  * 
+  * The bounds are found in closed form by evaluating the polynomial at
+  * the limits of the interval and at its critical points inside the
+  * interval, i.e., the roots of the polynomial's derivative.
+  */
+void spline_segment_get_bounds(
+  const spline_segment_t* segment,
+  spline_eval_type_t eval_type,
+  double x_max,
+  double* min,
+  double* max);
+
+/** \brief Solve a spline segment for a given value
+  * \param[in] segment The spline segment to be solved.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] y The value for which to solve the spline segment.
+  * \param[in] x_max The upper bound of the interval starting at the
+  *   location of the spline segment.
+  * \param[out] x The array of size 3 receiving the locations within the
+  *   interval at which the spline segment attains the given value, in
+  *   ascending order.
+  * \return The number of locations found.
+  * 
+  * The critical points of the polynomial are found in closed form and
+  * subdivide the interval into pieces of monotonic value. Each piece
+  * whose limits bracket the given value contains exactly one location,
+  * which is refined by safeguarded Newton iterations starting from the
+  * linear interpolation of the limits. For a spline segment which is
+  * constant at the given value, the limits of the interval are reported.
+  */
+size_t spline_segment_solve(
+  const spline_segment_t* segment,
+  spline_eval_type_t eval_type,
+  double y,
+  double x_max,
+  double* x);
+
 #endif
@@ -20,20 +20,56 @@
 
 #include <string.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#include <gsl/gsl_linalg.h>
+#if defined(__AVX__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
 
 #include "spline.h"
 
 #include "spline/segment.h"
+#include "spline/tridiag.h"
+#include "spline/binary.h"
 
 #include "string/string.h"
 
 #include "file/file.h"
+#include "file/reader.h"
 
 #define sqr(a) ((a)*(a))
 #define cub(a) ((a)*(a)*(a))
 
+#define SPLINE_EVAL_BLOCK_SIZE 64
+#define SPLINE_SOLVE_EPSILON 1e-12
+
+#if defined(__AVX__)
+  #define SPLINE_SIMD_WIDTH 4
+  #define spline_simd_t __m256d
+  #define spline_simd_load(a) _mm256_loadu_pd(a)
+  #define spline_simd_store(a, b) _mm256_storeu_pd(a, b)
+  #define spline_simd_set(a) _mm256_set1_pd(a)
+  #define spline_simd_add(a, b) _mm256_add_pd(a, b)
+  #define spline_simd_sub(a, b) _mm256_sub_pd(a, b)
+  #define spline_simd_mul(a, b) _mm256_mul_pd(a, b)
+  #define spline_simd_div(a, b) _mm256_div_pd(a, b)
+#elif defined(__SSE2__)
+  #define SPLINE_SIMD_WIDTH 2
+  #define spline_simd_t __m128d
+  #define spline_simd_load(a) _mm_loadu_pd(a)
+  #define spline_simd_store(a, b) _mm_storeu_pd(a, b)
+  #define spline_simd_set(a) _mm_set1_pd(a)
+  #define spline_simd_add(a, b) _mm_add_pd(a, b)
+  #define spline_simd_sub(a, b) _mm_sub_pd(a, b)
+  #define spline_simd_mul(a, b) _mm_mul_pd(a, b)
+  #define spline_simd_div(a, b) _mm_div_pd(a, b)
+#endif
+
 const char* spline_errors[] = {
   "Success",
   "Invalid spline segment",
@@ -42,11 +78,66 @@ const char* spline_errors[] = {
   "Failed to write spline to file",
   "Spline undefined at value",
   "Spline interpolation failed",
+  "Spline file checksum mismatch",
+  "Invalid number of spline curve channels",
 };
 
+const spline_segment_t* spline_update_segments(spline_t* spline);
+const size_t* spline_update_index(spline_t* spline);
+const double* spline_update_integrals(spline_t* spline);
+const double* spline_update_bounds(spline_t* spline, spline_eval_type_t
+  eval_type);
+ssize_t spline_find_segment_index(const spline_t* spline, double x);
+const spline_segment_t* spline_get_segment_cached(const spline_t* spline,
+  size_t index, spline_segment_t* segment);
+ssize_t spline_find_undefined(const spline_t* spline, const double* x,
+  size_t num_values);
+size_t spline_solve_segment(const spline_t* spline, spline_eval_type_t
+  eval_type, double y, size_t index, double* x, size_t num_roots, size_t
+  max_roots);
+int spline_is_mapped(const spline_t* spline, const void* data);
+void spline_unmap(spline_t* spline, int copy);
+int spline_int_workspace_tridiag_y1(spline_workspace_t* workspace, const
+  spline_point_t* points, size_t num_points, double d_1, double d_n, double
+  e_1, double c_m, double b_1, double b_n);
+int spline_int_workspace_tridiag_y2(spline_workspace_t* workspace, const
+  spline_point_t* points, size_t num_points, double d_1, double d_n, double
+  e_1, double c_m, double b_1, double b_n);
+int spline_int_workspace_symm_cyc_tridiag_y2(spline_workspace_t* workspace,
+  const spline_point_t* points, size_t num_points, double d_1, double e_m,
+  double b_1);
+ssize_t spline_find_segment_adjacent(const spline_t* spline, double x,
+  size_t index);
+void spline_eval_block(spline_eval_type_t eval_type, const double* x,
+  const double* a, const double* b, const double* c, const double* d,
+  const double* x_0, double* values, size_t num_values);
+void spline_eval_block_derivatives(const double* x, const double* a,
+  const double* b, const double* c, const double* d, const double* x_0,
+  double* y, double* y1, double* y2, size_t num_values);
+
 void spline_init(spline_t* spline) {
   spline->knots = 0;
   spline->num_knots = 0;
+  spline->capacity = 0;
+  
+  spline->segments = 0;
+  spline->num_segments = 0;
+  
+  spline->index = 0;
+  spline->num_buckets = 0;
+  spline->bucket_scale = 0.0;
+  
+  spline->integrals = 0;
+  spline->num_integrals = 0;
+  
+  spline->bounds = 0;
+  spline->num_bounds = 0;
+  spline->bounds_type = spline_eval_type_base_function;
+  
+  spline_workspace_init(&spline->workspace);
+  
+  spline->map = 0;
+  spline->map_size = 0;
   
   error_init(&spline->error, spline_errors);
 }
@@ -54,20 +145,232 @@ void spline_init(spline_t* spline) {
 void spline_destroy(spline_t* spline) {
   spline_clear(spline);
   
+  spline_workspace_destroy(&spline->workspace);
   error_destroy(&spline->error);
 }
 
 void spline_clear(spline_t* spline) {
-  if (spline->num_knots) {
+  spline_unmap(spline, 0);
+  
+  if (spline->knots) {
     free(spline->knots);
 
     spline->knots = 0;
     spline->num_knots = 0;
+    spline->capacity = 0;
+  }
+  
+  if (spline->segments) {
+    free(spline->segments);
+    
+    spline->segments = 0;
+    spline->num_segments = 0;
+  }
+  
+  if (spline->index) {
+    free(spline->index);
+    
+    spline->index = 0;
+    spline->num_buckets = 0;
+  }
+  
+  if (spline->integrals) {
+    free(spline->integrals);
+    
+    spline->integrals = 0;
+    spline->num_integrals = 0;
+  }
+  
+  if (spline->bounds) {
+    free(spline->bounds);
+    
+    spline->bounds = 0;
+    spline->num_bounds = 0;
   }
   
   error_clear(&spline->error);
 }
 
+void spline_invalidate(spline_t* spline) {
+  spline->num_segments = 0;
+  spline->num_buckets = 0;
+  spline->num_integrals = 0;
+  spline->num_bounds = 0;
+}
+
+void spline_invalidate_knots(spline_t* spline, size_t index) {
+  if (index < spline->num_segments+1)
+    spline->num_segments = index ? index-1 : 0;
+  if (index < spline->num_integrals)
+    spline->num_integrals = index;
+  spline->num_buckets = 0;
+  spline->num_bounds = 0;
+}
+
+void spline_prepare(spline_t* spline) {
+  spline_update_segments(spline);
+  spline_update_index(spline);
+  spline_update_integrals(spline);
+  spline_update_bounds(spline, spline_eval_type_base_function);
+}
+
+const spline_segment_t* spline_update_segments(spline_t* spline) {
+  if ((spline->num_segments+1 < spline->num_knots)) {
+    size_t i;
+    
+    if (!spline->num_segments) {
+      if (spline_is_mapped(spline, spline->segments))
+        spline->segments = 0;
+      spline->segments = realloc(spline->segments, spline->capacity*
+        sizeof(spline_segment_t));
+    }
+    for (i = spline->num_segments; i+1 < spline->num_knots; ++i)
+      spline_segment_init_knots(&spline->segments[i], &spline->knots[i],
+        &spline->knots[i+1]);
+    
+    spline->num_segments = spline->num_knots-1;
+  }
+  
+  return spline->segments;
+}
+
+const size_t* spline_update_index(spline_t* spline) {
+  if (!spline->num_buckets && (spline->num_knots > 1)) {
+    size_t num_buckets = spline->num_knots-1;
+    double x_0 = spline->knots[0].x;
+    double scale = num_buckets/(spline->knots[spline->num_knots-1].x-x_0);
+    size_t i, j = 0;
+    
+    spline->index = realloc(spline->index, (num_buckets+1)*sizeof(size_t));
+    spline->bucket_scale = isfinite(scale) ? scale : 0.0;
+    
+    for (i = 0; i < num_buckets; ++i) {
+      double x_i = spline->bucket_scale ? x_0+i/spline->bucket_scale : x_0;
+      
+      while ((j+2 < spline->num_knots) && (spline->knots[j+1].x <= x_i))
+        ++j;
+      spline->index[i] = j;
+    }
+    spline->index[num_buckets] = spline->num_knots-2;
+    
+    spline->num_buckets = num_buckets;
+  }
+  
+  return spline->index;
+}
+
+const double* spline_update_integrals(spline_t* spline) {
+  if (spline->num_integrals < spline->num_knots) {
+    const spline_segment_t* segments = spline_update_segments(spline);
+    size_t i;
+    
+    if (!spline->num_integrals) {
+      spline->integrals = realloc(spline->integrals, spline->capacity*
+        sizeof(double));
+      spline->integrals[0] = 0.0;
+      spline->num_integrals = 1;
+    }
+    for (i = spline->num_integrals; i < spline->num_knots; ++i)
+      spline->integrals[i] = spline->integrals[i-1]+
+        spline_segment_integrate(&segments[i-1], spline->knots[i-1].x,
+        spline->knots[i].x);
+    
+    spline->num_integrals = spline->num_knots;
+  }
+  
+  return spline->integrals;
+}
+
+const double* spline_update_bounds(spline_t* spline, spline_eval_type_t
+    eval_type) {
+  if ((!spline->num_bounds || (spline->bounds_type != eval_type)) &&
+      (spline->num_knots > 1)) {
+    const spline_segment_t* segments = spline_update_segments(spline);
+    size_t num_segments = spline->num_knots-1, num_leaves = 1;
+    size_t i;
+    
+    while (num_leaves < num_segments)
+      num_leaves <<= 1;
+    spline->bounds = realloc(spline->bounds, 4*num_leaves*sizeof(double));
+    
+    for (i = 0; i < num_leaves; ++i) {
+      double* bounds = &spline->bounds[2*(num_leaves+i)];
+      
+      if (i < num_segments)
+        spline_segment_get_bounds(&segments[i], eval_type,
+          spline->knots[i+1].x, &bounds[0], &bounds[1]);
+      else {
+        bounds[0] = INFINITY;
+        bounds[1] = -INFINITY;
+      }
+    }
+    for (i = num_leaves-1; i > 0; --i) {
+      const double* left = &spline->bounds[4*i];
+      const double* right = &spline->bounds[4*i+2];
+      
+      spline->bounds[2*i] = (left[0] < right[0]) ? left[0] : right[0];
+      spline->bounds[2*i+1] = (left[1] > right[1]) ? left[1] : right[1];
+    }
+    
+    spline->num_bounds = num_leaves;
+    spline->bounds_type = eval_type;
+  }
+  
+  return spline->bounds;
+}
+
+ssize_t spline_find_segment_index(const spline_t* spline, double x) {
+  const spline_knot_t* knots = spline->knots;
+  
+  if ((spline->num_knots < 2) || !(x >= knots[0].x) ||
+      !(x <= knots[spline->num_knots-1].x))
+    return -1;
+  
+  size_t k = (x-knots[0].x)*spline->bucket_scale;
+  if (k >= spline->num_buckets)
+    k = spline->num_buckets-1;
+  
+  size_t i = spline->index[k];
+  size_t j = spline->index[k+1]+1;
+  
+  if (x < knots[i].x)
+    i = 0;
+  if (x > knots[j].x)
+    j = spline->num_knots-1;
+  
+  while (j-i > 1) {
+    size_t l = (i+j) >> 1;
+    if (knots[l].x > x)
+      j = l;
+    else
+      i = l;
+  }
+  
+  return i;
+}
+
+const spline_segment_t* spline_get_segment_cached(const spline_t* spline,
+    size_t index, spline_segment_t* segment) {
+  if (index < spline->num_segments)
+    return &spline->segments[index];
+  
+  spline_segment_init_knots(segment, &spline->knots[index],
+    &spline->knots[index+1]);
+  return segment;
+}
+
+ssize_t spline_find_undefined(const spline_t* spline, const double* x,
+    size_t num_values) {
+  size_t i;
+  
+  for (i = 0; i < num_values; ++i)
+    if ((spline->num_knots < 2) || !(x[i] >= spline->knots[0].x) ||
+        !(x[i] <= spline->knots[spline->num_knots-1].x))
+      return i;
+  
+  return -1;
+}
+
 size_t spline_get_num_segments(const spline_t* spline) {
   return spline->num_knots ? spline->num_knots-1 : 0;
 }
@@ -76,24 +379,49 @@ int spline_get_segment(spline_t* spline, size_t index, spline_segment_t*
     segment) {
   error_clear(&spline->error);
   
-  if ((index >= 0) && (index+1 < spline->num_knots)) {
-    double x_1 = spline->knots[index+1].x-spline->knots[index].x;
-      
-    segment->a = (spline->knots[index+1].y2-spline->knots[index].y2)/(6.0*x_1);
-    segment->b = 0.5*spline->knots[index].y2;
-    segment->c = (spline->knots[index+1].y-segment->a*cub(x_1)-
-      segment->b*sqr(x_1)-spline->knots[index].y)/x_1;
-    segment->d = spline->knots[index].y;
-  }
+  if ((index >= 0) && (index+1 < spline->num_knots))
+    spline_segment_copy(segment, &spline_update_segments(spline)[index]);
   else
     error_setf(&spline->error, SPLINE_ERROR_SEGMENT, "%d", (int)index);
   
   return spline->error.code;
 }
 
+int spline_get_segment_r(const spline_t* spline, size_t index,
+    spline_segment_t* segment) {
+  spline_segment_t cached;
+  
+  if (index+1 < spline->num_knots) {
+    spline_segment_copy(segment, spline_get_segment_cached(spline, index,
+      &cached));
+    return SPLINE_ERROR_NONE;
+  }
+  else
+    return SPLINE_ERROR_SEGMENT;
+}
+
 ssize_t spline_find_segment(spline_t* spline, double x) {
-  return spline_find_segment_bisect(spline, x, 0,
-    spline->num_knots > 1 ? spline->num_knots-1 : 0);
+  ssize_t i;
+  
+  error_clear(&spline->error);
+  
+  spline_update_index(spline);
+  if ((i = spline_find_segment_index(spline, x)) >= 0)
+    return i;
+  
+  error_setf(&spline->error, SPLINE_ERROR_UNDEFINED, "%lg", x);
+  return -spline->error.code;
+}
+
+ssize_t spline_find_segment_r(const spline_t* spline, double x) {
+  ssize_t i;
+  
+  if (spline->num_buckets)
+    i = spline_find_segment_index(spline, x);
+  else
+    i = spline_find_segment_adjacent(spline, x, 0);
+  
+  return (i >= 0) ? i : -SPLINE_ERROR_UNDEFINED;
 }
 
 ssize_t spline_find_segment_bisect(spline_t* spline, double x, size_t
@@ -177,19 +505,26 @@ int spline_read(const char* filename, spline_t* spline) {
     return -error_get(&spline->error);
   }
   
-  char* line = 0;
-  while (!file_eof(&file) && (file_read_line(&file, &line, 128) >= 0)) {
+  file_reader_t reader;
+  file_reader_init(&reader, &file, 0);
+  
+  char* line;
+  while (!file_reader_eof(&reader) &&
+      (file_reader_read_line(&reader, &line) >= 0)) {
     if (string_empty(line) || string_starts_with(line, "#"))
       continue;
-      
-    if (string_scanf(line, "%lg %lg %lg", &knot.x, &knot.y, &knot.y2) != 3) {
+    
+    size_t n_x, n_y;
+    if (!(n_x = string_parse_float(line, &knot.x)) ||
+        !(n_y = string_parse_float(&line[n_x], &knot.y)) ||
+        !string_parse_float(&line[n_x+n_y], &knot.y2)) {
       error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, line);
       break;
     }
 
     spline_add_knot(spline, &knot);
   }
-  string_destroy(&line);
+  file_reader_destroy(&reader);
   
   if (file.error.code)
     error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_READ);
@@ -223,11 +558,200 @@ int spline_write(const char* filename, spline_t* spline) {
 
   return spline->error.code ? -spline->error.code : spline->num_knots;
 }
+
+int spline_read_binary(const char* filename, spline_t* spline) {
+  spline_binary_header_t header;
+  file_t file;
+
+  spline_clear(spline);
+  error_clear(&spline->error);
+  
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdin, file_mode_read);
+  else
+    file_open(&file, file_mode_read);
+
+  if (!file.handle) {
+    error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_READ);
+    file_destroy(&file);
+    
+    return -error_get(&spline->error);
+  }
+  
+  if (file_read(&file, (unsigned char*)&header, sizeof(header)) ==
+      sizeof(header)) {
+    if (spline_binary_header_valid(&header) &&
+        (spline_binary_get_payload_size(&header) >= 0)) {
+      size_t size = header.num_knots*sizeof(spline_knot_t);
+      uint64_t checksum = 0;
+      
+      spline_reserve_knots(spline, header.num_knots);
+      if (spline->capacity < header.num_knots) {
+        error_setf(&spline->error, SPLINE_ERROR_FILE_READ, filename);
+        file_destroy(&file);
+        
+        return -error_get(&spline->error);
+      }
+      
+      if (file_read(&file, (unsigned char*)spline->knots, size) == size) {
+        checksum = spline_binary_checksum(checksum, spline->knots, size);
+        spline->num_knots = header.num_knots;
+      }
+      
+      if ((spline->num_knots > 1) &&
+          (header.flags & SPLINE_BINARY_FLAG_SEGMENTS)) {
+        spline_segment_t* segments = realloc(spline->segments,
+          spline->capacity*sizeof(spline_segment_t));
+        
+        if (!segments) {
+          spline->num_knots = 0;
+          
+          error_setf(&spline->error, SPLINE_ERROR_FILE_READ, filename);
+          file_destroy(&file);
+          
+          return -error_get(&spline->error);
+        }
+        
+        spline->segments = segments;
+        size = (spline->num_knots-1)*sizeof(spline_segment_t);
+        
+        if (file_read(&file, (unsigned char*)spline->segments, size) ==
+            size) {
+          checksum = spline_binary_checksum(checksum, spline->segments, size);
+          spline->num_segments = spline->num_knots-1;
+        }
+        else
+          spline->num_knots = 0;
+      }
+      
+      if (spline->num_knots != header.num_knots) {
+        spline->num_knots = 0;
+        
+        if (file.error.code)
+          error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_READ);
+        else
+          error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, filename);
+      }
+      else if (checksum != header.checksum) {
+        spline_invalidate(spline);
+        spline->num_knots = 0;
+        
+        error_setf(&spline->error, SPLINE_ERROR_FILE_CHECKSUM, filename);
+      }
+    }
+    else
+      error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, filename);
+  }
+  else if (file.error.code)
+    error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_READ);
+  else
+    error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, filename);
+  
+  file_destroy(&file);
+
+  return spline->error.code ? -spline->error.code : spline->num_knots;
+}
+
+int spline_write_binary(const char* filename, spline_t* spline, int
+    segments) {
+  spline_binary_header_t header;
+  file_t file;
+
+  error_clear(&spline->error);
+  
+  spline_binary_header_init(&header, spline->num_knots,
+    (segments && (spline->num_knots > 1)) ? SPLINE_BINARY_FLAG_SEGMENTS : 0);
+  
+  size_t knots_size = spline->num_knots*sizeof(spline_knot_t);
+  size_t segments_size = 0;
+  
+  header.checksum = spline_binary_checksum(0, spline->knots, knots_size);
+  if (header.flags & SPLINE_BINARY_FLAG_SEGMENTS) {
+    spline_update_segments(spline);
+    segments_size = spline->num_segments*sizeof(spline_segment_t);
+    
+    header.checksum = spline_binary_checksum(header.checksum,
+      spline->segments, segments_size);
+  }
+  
+  file_init_name(&file, filename);
+  if (string_equal(filename, "-"))
+    file_open_stream(&file, stdout, file_mode_write);
+  else
+    file_open(&file, file_mode_write);
+
+  if ((file_write(&file, (unsigned char*)&header, sizeof(header)) >= 0) &&
+      (!knots_size || (file_write(&file, (unsigned char*)spline->knots,
+        knots_size) >= 0)) && segments_size)
+    file_write(&file, (unsigned char*)spline->segments, segments_size);
+
+  if (file.error.code)
+    error_blame(&spline->error, &file.error, SPLINE_ERROR_FILE_WRITE);
+  file_destroy(&file);
+
+  return spline->error.code ? -spline->error.code : spline->num_knots;
+}
+
+int spline_map(const char* filename, spline_t* spline, int verify) {
+  spline_binary_header_t* header;
+  struct stat file_stat;
+  void* map = MAP_FAILED;
+  int fd;
+
+  spline_clear(spline);
+  error_clear(&spline->error);
+  
+  if (((fd = open(filename, O_RDONLY)) >= 0) && !fstat(fd, &file_stat) &&
+      (file_stat.st_size >= (ssize_t)sizeof(spline_binary_header_t)))
+    map = mmap(0, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+      fd, 0);
+  if (fd >= 0)
+    close(fd);
+    
+  if (map == MAP_FAILED) {
+    error_setf(&spline->error, SPLINE_ERROR_FILE_READ, filename);
+    return -error_get(&spline->error);
+  }
+  
+  spline->map = map;
+  spline->map_size = file_stat.st_size;
+  
+  header = map;
+  if (spline_binary_header_valid(header) && (header->num_knots <=
+      spline_binary_get_max_knots(header, spline->map_size))) {
+    if (!verify || (spline_binary_checksum(0, &header[1],
+        spline_binary_get_payload_size(header)) == header->checksum)) {
+      if (header->num_knots) {
+        spline->knots = (spline_knot_t*)&header[1];
+        spline->num_knots = header->num_knots;
+        spline->capacity = header->num_knots;
+      }
+      
+      if ((spline->num_knots > 1) &&
+          (header->flags & SPLINE_BINARY_FLAG_SEGMENTS)) {
+        spline->segments = (spline_segment_t*)
+          &spline->knots[spline->num_knots];
+        spline->num_segments = spline->num_knots-1;
+      }
+    }
+    else
+      error_setf(&spline->error, SPLINE_ERROR_FILE_CHECKSUM, filename);
+  }
+  else
+    error_setf(&spline->error, SPLINE_ERROR_FILE_FORMAT, filename);
+  
+  if (spline->error.code)
+    spline_unmap(spline, 0);
+  
+  return spline->error.code ? -spline->error.code : spline->num_knots;
+}
  
 size_t spline_add_knot(spline_t* spline, const spline_knot_t* knot) {
   if (spline->num_knots &&
       (spline->knots[spline->num_knots-1].x >= knot->x)) {
-    ssize_t i = spline_find_segment(spline, knot->x);
+    ssize_t i = spline_find_segment_bisect(spline, knot->x, 0,
+      spline->num_knots-1);
   
     if (i < 0) {
       error_clear(&spline->error);
@@ -241,29 +765,97 @@ size_t spline_add_knot(spline_t* spline, const spline_knot_t* knot) {
     else if (spline->knots[i+1].x == knot->x)
       spline_knot_copy(&spline->knots[i+1], knot);
     else {
-      spline->knots = realloc(spline->knots,
-        (spline->num_knots+1)*sizeof(spline_knot_t));
+      if (spline_reserve_knots(spline, spline->num_knots+1) <=
+          spline->num_knots) {
+        error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+        return spline->num_knots;
+      }
       memmove(&spline->knots[i+1], &spline->knots[i],
         (spline->num_knots-i)*sizeof(spline_knot_t));
         
       spline_knot_copy(&spline->knots[i], knot);
       ++spline->num_knots;
     }
+    
+    spline_invalidate_knots(spline, i);
   }
   else {
-    spline->knots = realloc(spline->knots,
-      (spline->num_knots+1)*sizeof(spline_knot_t));
+    if (spline_reserve_knots(spline, spline->num_knots+1) <=
+        spline->num_knots) {
+      error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+      return spline->num_knots;
+    }
     
     spline_knot_copy(&spline->knots[spline->num_knots], knot);
     ++spline->num_knots;
+    
+    spline_invalidate_knots(spline, spline->num_knots-1);
   }
   
   return spline->num_knots;
 }
 
+size_t spline_reserve_knots(spline_t* spline, size_t num_knots) {
+  spline_knot_t* knots;
+  
+  if (num_knots > spline->capacity) {
+    spline_unmap(spline, 1);
+    
+    if (num_knots < 2*spline->capacity)
+      num_knots = 2*spline->capacity;
+    
+    if (num_knots > SIZE_MAX/sizeof(spline_knot_t))
+      return spline->capacity;
+    knots = realloc(spline->knots, num_knots*sizeof(spline_knot_t));
+    if (!knots)
+      return spline->capacity;
+    
+    spline->knots = knots;
+    spline->capacity = num_knots;
+    
+    spline_invalidate(spline);
+  }
+  
+  return spline->capacity;
+}
+
+int spline_is_mapped(const spline_t* spline, const void* data) {
+  return spline->map && ((const char*)data >= (const char*)spline->map) &&
+    ((const char*)data < (const char*)spline->map+spline->map_size);
+}
+
+void spline_unmap(spline_t* spline, int copy) {
+  if (spline->map) {
+    if (spline_is_mapped(spline, spline->knots)) {
+      if (copy) {
+        spline_knot_t* knots = malloc(spline->capacity*sizeof(spline_knot_t));
+        memcpy(knots, spline->knots, spline->num_knots*sizeof(spline_knot_t));
+        
+        spline->knots = knots;
+      }
+      else {
+        spline->knots = 0;
+        spline->num_knots = 0;
+        spline->capacity = 0;
+      }
+    }
+    
+    if (spline_is_mapped(spline, spline->segments)) {
+      spline->segments = 0;
+      spline->num_segments = 0;
+    }
+    
+    munmap(spline->map, spline->map_size);
+    
+    spline->map = 0;
+    spline->map_size = 0;
+  }
+}
+
 ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y1_0, double y1_n) {
   error_clear(&spline->error);
+  spline_invalidate(spline);
   
   if (num_points > 2) {
     double h_1 = points[1].x-points[0].x;
@@ -273,13 +865,15 @@ ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
     double b_n = 6.0/h_n*(y1_n-(points[num_points-1].y-
       points[num_points-2].y)/h_n);
     
-    double* y2 = 0;
-    ssize_t result;
+    int result;
     
-    if ((result = spline_int_solve_tridiag_y2(points, num_points, 2.0, 2.0,
-        1.0, 1.0, b_1, b_n, &y2)) > 0) {    
-      spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
-      spline->num_knots = result;
+    if (!(result = spline_int_workspace_tridiag_y2(&spline->workspace,
+        points, num_points, 2.0, 2.0, 1.0, 1.0, b_1, b_n)) &&
+        (spline_reserve_knots(spline, num_points) < num_points))
+      result = SPLINE_ERROR_INTERPOLATION;
+    
+    if (!result) {
+      spline->num_knots = num_points;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -287,12 +881,11 @@ ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
 
         knot->x = points[i].x;
         knot->y = points[i].y;
-        knot->y2 = y2[i];
+        knot->y2 = spline->workspace.b[i];
       }
-      free(y2);
     }
     else
-      error_set(&spline->error, -result);
+      error_set(&spline->error, result);
   }
   else
     error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
@@ -303,15 +896,18 @@ ssize_t spline_int_y1(spline_t* spline, const spline_point_t* points,
 ssize_t spline_int_y2(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y2_0, double y2_n) {
   error_clear(&spline->error);
+  spline_invalidate(spline);
   
   if (num_points > 2) {
-    double* y2 = 0;
-    ssize_t result;
+    int result;
+    
+    if (!(result = spline_int_workspace_tridiag_y2(&spline->workspace,
+        points, num_points, 1.0, 1.0, 0.0, 0.0, y2_0, y2_n)) &&
+        (spline_reserve_knots(spline, num_points) < num_points))
+      result = SPLINE_ERROR_INTERPOLATION;
     
-    if ((result = spline_int_solve_tridiag_y2(points, num_points, 1.0, 1.0,
-        0.0, 0.0, y2_0, y2_n, &y2)) > 0) {    
-      spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
-      spline->num_knots = result;
+    if (!result) {
+      spline->num_knots = num_points;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -319,12 +915,11 @@ ssize_t spline_int_y2(spline_t* spline, const spline_point_t* points,
 
         knot->x = points[i].x;
         knot->y = points[i].y;
-        knot->y2 = y2[i];
+        knot->y2 = spline->workspace.b[i];
       }
-      free(y2);
     }
     else
-      error_set(&spline->error, -result);
+      error_set(&spline->error, result);
   }
   else
     error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
@@ -336,6 +931,7 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
     size_t num_points, double y1_0, double y1_n, double y2_0, double y2_n,
     double r_0, double r_n) {
   error_clear(&spline->error);
+  spline_invalidate(spline);
   
   if (num_points > 4) {
     double h_1 = r_0*(points[1].x-points[0].x);
@@ -365,19 +961,24 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
     double b_n = 6.0*((points[num_points-2].y-points[num_points-1].y)/h_m+
       y1_n*(1.0+h_n/h_m)-y2_n*(0.5+h_n/(3.0*h_m))*h_n);
     
-    gsl_vector* c = gsl_vector_alloc(num_points-1);
-    gsl_vector* d = gsl_vector_alloc(num_points);
-    gsl_vector* e = gsl_vector_alloc(num_points-1);
-    gsl_vector* x = gsl_vector_alloc(num_points);
-    gsl_vector* b = gsl_vector_alloc(num_points);
+    spline_workspace_t* workspace = &spline->workspace;
+    if (spline_workspace_reserve(workspace, num_points) < num_points) {
+      error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+      return -spline->error.code;
+    }
     
-    gsl_vector_set(d, 0, d_1);
-    gsl_vector_set(e, 0, e_1);
-    gsl_vector_set(b, 0, b_1);
-    gsl_vector_set(c, 0, c_1);
-    gsl_vector_set(d, 1, d_2);
-    gsl_vector_set(e, 1, e_2);
-    gsl_vector_set(b, 1, b_2);
+    double* c = workspace->c;
+    double* d = workspace->d;
+    double* e = workspace->e;
+    double* b = workspace->b;
+    
+    d[0] = d_1;
+    e[0] = e_1;
+    b[0] = b_1;
+    c[0] = c_1;
+    d[1] = d_2;
+    e[1] = e_2;
+    b[1] = b_2;
     
     size_t i;
     double h_i, h_j = 0.0;
@@ -385,36 +986,31 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
       h_i = (i > 2) ? h_j : points[i].x-points[i-1].x;
       h_j = points[i+1].x-points[i].x;
       
-      double d_i = 2.0*(h_i+h_j);
-      double c_i = h_i;
-      double e_i = h_j;
-      double b_i = 6.0*((points[i+1].y-points[i].y)/h_j-
+      c[i-1] = h_i;
+      d[i] = 2.0*(h_i+h_j);
+      e[i] = h_j;
+      b[i] = 6.0*((points[i+1].y-points[i].y)/h_j-
         (points[i].y-points[i-1].y)/h_i);
-      
-      gsl_vector_set(c, i-1, c_i);
-      gsl_vector_set(d, i, d_i);
-      gsl_vector_set(e, i, e_i);
-      gsl_vector_set(b, i, b_i);
-    }
-    
-    gsl_vector_set(c, num_points-3, c_l);
-    gsl_vector_set(d, num_points-2, d_m);
-    gsl_vector_set(e, num_points-2, e_m);
-    gsl_vector_set(b, num_points-2, b_m);
-    gsl_vector_set(c, num_points-2, c_m);
-    gsl_vector_set(d, num_points-1, d_n);
-    gsl_vector_set(b, num_points-1, b_n);
-
-    if (!gsl_linalg_solve_tridiag(d, e, c, b, x)) {
-      spline->knots = realloc(spline->knots, (num_points+2)*
-        sizeof(spline_knot_t));
+    }
+    
+    c[num_points-3] = c_l;
+    d[num_points-2] = d_m;
+    e[num_points-2] = e_m;
+    b[num_points-2] = b_m;
+    c[num_points-2] = c_m;
+    d[num_points-1] = d_n;
+    b[num_points-1] = b_n;
+
+    if (!spline_tridiag_solve_parallel(c, d, e, b, workspace->w,
+        workspace->z, num_points, workspace->num_threads) &&
+        (spline_reserve_knots(spline, num_points+2) >= num_points+2)) {
       spline->num_knots = num_points+2;
 
       spline->knots[0].x = points[0].x;
       spline->knots[0].y = points[0].y;
       spline->knots[0].y2 = y2_0;
       spline->knots[1].x = points[0].x+h_1;
-      spline->knots[1].y2 = gsl_vector_get(x, 0);
+      spline->knots[1].y2 = b[0];
       spline->knots[1].y = (y2_0/3.0*h_1+spline->knots[1].y2/6.0*h_1+y1_0)*
         h_1+points[0].y;
       
@@ -424,11 +1020,11 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
 
         knot->x = points[i].x;
         knot->y = points[i].y;
-        knot->y2 = gsl_vector_get(x, i);
+        knot->y2 = b[i];
       }
 
       spline->knots[spline->num_knots-2].x = points[num_points-1].x-h_n;
-      spline->knots[spline->num_knots-2].y2 = gsl_vector_get(x, num_points-1);
+      spline->knots[spline->num_knots-2].y2 = b[num_points-1];
       spline->knots[spline->num_knots-2].y = (y2_n/3.0*h_n+
         spline->knots[spline->num_knots-2].y2/6.0*h_n-y1_n)*h_n+
         points[num_points-1].y;
@@ -438,12 +1034,6 @@ ssize_t spline_int_y1_y2(spline_t* spline, const spline_point_t* points,
     }
     else
       error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
-    
-    gsl_vector_free(c);
-    gsl_vector_free(d);
-    gsl_vector_free(e);
-    gsl_vector_free(x);
-    gsl_vector_free(b);
   }
   else
     error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
@@ -464,6 +1054,7 @@ ssize_t spline_int_clamped(spline_t* spline, const spline_point_t* points,
 ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
     size_t num_points) {
   error_clear(&spline->error);
+  spline_invalidate(spline);
   
   if (num_points > 2) {
     double h_1 = points[1].x-points[0].x;
@@ -474,14 +1065,15 @@ ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
     double b_1 = 6.0*((points[1].y-points[0].y)/h_1-
       (points[num_points-1].y-points[num_points-2].y)/h_m);
     
-    double* y2 = 0;
-    ssize_t result;
+    int result;
+    
+    if (!(result = spline_int_workspace_symm_cyc_tridiag_y2(
+        &spline->workspace, points, num_points, d_1, e_m, b_1)) &&
+        (spline_reserve_knots(spline, num_points) < num_points))
+      result = SPLINE_ERROR_INTERPOLATION;
     
-    if ((result = spline_int_solve_symm_cyc_tridiag_y2(points, num_points,
-        d_1, e_m, b_1, &y2)) > 0) {
-      spline->knots = realloc(spline->knots, (result+1)*
-        sizeof(spline_knot_t));
-      spline->num_knots = result+1;
+    if (!result) {
+      spline->num_knots = num_points;
       
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -489,12 +1081,11 @@ ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
 
         knot->x = points[i].x;
         knot->y = points[i].y;
-        knot->y2 = y2[(i+1 < spline->num_knots) ? i : 0];
+        knot->y2 = spline->workspace.b[(i+1 < spline->num_knots) ? i : 0];
       }
-      free(y2);
     }
     else
-      error_set(&spline->error, -result);
+      error_set(&spline->error, result);
   }
   else
     error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
@@ -505,6 +1096,7 @@ ssize_t spline_int_periodic(spline_t* spline, const spline_point_t* points,
 ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
     size_t num_points) {
   error_clear(&spline->error);
+  spline_invalidate(spline);
   
   if (num_points > 4) {
     double h_1 = points[1].x-points[0].x;
@@ -521,13 +1113,15 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
     double b_n = 6.0*((points[num_points-1].y-points[num_points-2].y)/h_n-
       (points[num_points-2].y-points[num_points-3].y)/h_m);
         
-    double* y2 = 0;
-    ssize_t result;
+    int result;
     
-    if ((result = spline_int_solve_tridiag_y2(&points[1], num_points-2,
-        d_1, d_n, e_1, c_m, b_1, b_n, &y2)) > 0) {    
-      spline->knots = realloc(spline->knots, result*sizeof(spline_knot_t));
-      spline->num_knots = result;
+    if (!(result = spline_int_workspace_tridiag_y2(&spline->workspace,
+        &points[1], num_points-2, d_1, d_n, e_1, c_m, b_1, b_n)) &&
+        (spline_reserve_knots(spline, num_points-2) < num_points-2))
+      result = SPLINE_ERROR_INTERPOLATION;
+    
+    if (!result) {
+      spline->num_knots = num_points-2;
     
       size_t i;
       for (i = 0; i < spline->num_knots; ++i) {
@@ -535,9 +1129,8 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
 
         knot->x = points[i+1].x;
         knot->y = points[i+1].y;
-        knot->y2 = y2[i];
+        knot->y2 = spline->workspace.b[i];
       }
-      free(y2);
       
       spline_knot_t* knot_1 = &spline->knots[0];
       knot_1->y2 = spline_knot_eval(&spline->knots[0],
@@ -553,7 +1146,7 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
       knot_n->y = points[num_points-1].y;
     }
     else
-      error_set(&spline->error, -result);
+      error_set(&spline->error, result);
   }
   else
     error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
@@ -564,18 +1157,91 @@ ssize_t spline_int_not_a_knot(spline_t* spline, const spline_point_t* points,
 ssize_t spline_int_solve_tridiag_y1(const spline_point_t* points, size_t
     num_points, double d_1, double d_n, double e_1, double c_m, double b_1,
     double b_n, double** y1) {
-  if (num_points > 2) {
+  spline_workspace_t workspace;
+  ssize_t result = -SPLINE_ERROR_INTERPOLATION;
+  
+  spline_workspace_init(&workspace);
+  
+  if (!spline_int_workspace_tridiag_y1(&workspace, points, num_points,
+      d_1, d_n, e_1, c_m, b_1, b_n)) {
     *y1 = realloc(*y1, num_points*sizeof(double));
+    memcpy(*y1, workspace.b, num_points*sizeof(double));
+    
+    result = num_points;
+  }
+  else if (*y1) {
+    free(*y1);
+    *y1 = 0;
+  }
+  
+  spline_workspace_destroy(&workspace);
+  
+  return result;
+}
+
+ssize_t spline_int_solve_tridiag_y2(const spline_point_t* points, size_t
+    num_points, double d_1, double d_n, double e_1, double c_m, double b_1,
+    double b_n, double** y2) {
+  spline_workspace_t workspace;
+  ssize_t result = -SPLINE_ERROR_INTERPOLATION;
+  
+  spline_workspace_init(&workspace);
+  
+  if (!spline_int_workspace_tridiag_y2(&workspace, points, num_points,
+      d_1, d_n, e_1, c_m, b_1, b_n)) {
+    *y2 = realloc(*y2, num_points*sizeof(double));
+    memcpy(*y2, workspace.b, num_points*sizeof(double));
+    
+    result = num_points;
+  }
+  else if (*y2) {
+    free(*y2);
+    *y2 = 0;
+  }
+  
+  spline_workspace_destroy(&workspace);
+  
+  return result;
+}
+
+ssize_t spline_int_solve_symm_cyc_tridiag_y2(const spline_point_t* points,
+    size_t num_points, double d_1, double e_m, double b_1, double** y2) {
+  spline_workspace_t workspace;
+  ssize_t result = -SPLINE_ERROR_INTERPOLATION;
+  
+  spline_workspace_init(&workspace);
+  
+  if (!spline_int_workspace_symm_cyc_tridiag_y2(&workspace, points,
+      num_points, d_1, e_m, b_1)) {
+    *y2 = realloc(*y2, (num_points-1)*sizeof(double));
+    memcpy(*y2, workspace.b, (num_points-1)*sizeof(double));
     
-    gsl_vector* c = gsl_vector_alloc(num_points-1);
-    gsl_vector* d = gsl_vector_alloc(num_points);
-    gsl_vector* e = gsl_vector_alloc(num_points-1);
-    gsl_vector_view x = gsl_vector_view_array(*y1, num_points);
-    gsl_vector* b = gsl_vector_alloc(num_points);
+    result = num_points-1;
+  }
+  else if (*y2) {
+    free(*y2);
+    *y2 = 0;
+  }
+  
+  spline_workspace_destroy(&workspace);
+  
+  return result;
+}
+
+int spline_int_workspace_tridiag_y1(spline_workspace_t* workspace, const
+    spline_point_t* points, size_t num_points, double d_1, double d_n,
+    double e_1, double c_m, double b_1, double b_n) {
+  if ((num_points > 2) &&
+      (spline_workspace_reserve(workspace, num_points) >= num_points)) {
     
-    gsl_vector_set(d, 0, d_1);
-    gsl_vector_set(e, 0, e_1);
-    gsl_vector_set(b, 0, b_1);
+    double* c = workspace->c;
+    double* d = workspace->d;
+    double* e = workspace->e;
+    double* b = workspace->b;
+    
+    d[0] = d_1;
+    e[0] = e_1;
+    b[0] = b_1;
     
     size_t i;
     double h_i, h_j = 0.0;
@@ -583,55 +1249,38 @@ ssize_t spline_int_solve_tridiag_y1(const spline_point_t* points, size_t
       h_i = (i > 1) ? h_j : points[i].x-points[i-1].x;
       h_j = points[i+1].x-points[i].x;
       
-      double d_i = 2.0*(h_i+h_j);
-      double c_i = h_i;
-      double e_i = h_j;
-      double b_i = 3.0*(h_i*(points[i+1].y-points[i].y)/h_j+
+      c[i-1] = h_i;
+      d[i] = 2.0*(h_i+h_j);
+      e[i] = h_j;
+      b[i] = 3.0*(h_i*(points[i+1].y-points[i].y)/h_j+
         h_j*(points[i].y-points[i-1].y)/h_i);
-      
-      gsl_vector_set(c, i-1, c_i);
-      gsl_vector_set(d, i, d_i);
-      gsl_vector_set(e, i, e_i);
-      gsl_vector_set(b, i, b_i);
     }
     
-    gsl_vector_set(c, num_points-2, c_m);
-    gsl_vector_set(d, num_points-1, d_n);
-    gsl_vector_set(b, num_points-1, b_n);
+    c[num_points-2] = c_m;
+    d[num_points-1] = d_n;
+    b[num_points-1] = b_n;
 
-    int result = gsl_linalg_solve_tridiag(d, e, c, b, &x.vector);
-    
-    gsl_vector_free(c);
-    gsl_vector_free(d);
-    gsl_vector_free(e);
-    gsl_vector_free(b);
-
-    if (result) {
-      free(*y1);
-      *y1 = 0;
-    }
-    else
-      return num_points;
+    return spline_tridiag_solve_parallel(c, d, e, b, workspace->w,
+      workspace->z, num_points, workspace->num_threads);
   }
   
-  return -SPLINE_ERROR_INTERPOLATION;
+  return SPLINE_ERROR_INTERPOLATION;
 }
 
-ssize_t spline_int_solve_tridiag_y2(const spline_point_t* points, size_t
-    num_points, double d_1, double d_n, double e_1, double c_m, double b_1,
-    double b_n, double** y2) {
-  if (num_points > 2) {
-    *y2 = realloc(*y2, num_points*sizeof(double));
+int spline_int_workspace_tridiag_y2(spline_workspace_t* workspace, const
+    spline_point_t* points, size_t num_points, double d_1, double d_n,
+    double e_1, double c_m, double b_1, double b_n) {
+  if ((num_points > 2) &&
+      (spline_workspace_reserve(workspace, num_points) >= num_points)) {
     
-    gsl_vector* c = gsl_vector_alloc(num_points-1);
-    gsl_vector* d = gsl_vector_alloc(num_points);
-    gsl_vector* e = gsl_vector_alloc(num_points-1);
-    gsl_vector_view x = gsl_vector_view_array(*y2, num_points);
-    gsl_vector* b = gsl_vector_alloc(num_points);
+    double* c = workspace->c;
+    double* d = workspace->d;
+    double* e = workspace->e;
+    double* b = workspace->b;
     
-    gsl_vector_set(d, 0, d_1);
-    gsl_vector_set(e, 0, e_1);
-    gsl_vector_set(b, 0, b_1);
+    d[0] = d_1;
+    e[0] = e_1;
+    b[0] = b_1;
     
     size_t i;
     double h_i, h_j = 0.0;
@@ -639,52 +1288,36 @@ ssize_t spline_int_solve_tridiag_y2(const spline_point_t* points, size_t
       h_i = (i > 1) ? h_j : points[i].x-points[i-1].x;
       h_j = points[i+1].x-points[i].x;
       
-      double d_i = 2.0*(h_i+h_j);
-      double c_i = h_i;
-      double e_i = h_j;
-      double b_i = 6.0*((points[i+1].y-points[i].y)/h_j-
+      c[i-1] = h_i;
+      d[i] = 2.0*(h_i+h_j);
+      e[i] = h_j;
+      b[i] = 6.0*((points[i+1].y-points[i].y)/h_j-
         (points[i].y-points[i-1].y)/h_i);
-      
-      gsl_vector_set(c, i-1, c_i);
-      gsl_vector_set(d, i, d_i);
-      gsl_vector_set(e, i, e_i);
-      gsl_vector_set(b, i, b_i);
     }
     
-    gsl_vector_set(c, num_points-2, c_m);
-    gsl_vector_set(d, num_points-1, d_n);
-    gsl_vector_set(b, num_points-1, b_n);
+    c[num_points-2] = c_m;
+    d[num_points-1] = d_n;
+    b[num_points-1] = b_n;
 
-    int result = gsl_linalg_solve_tridiag(d, e, c, b, &x.vector);
-    
-    gsl_vector_free(c);
-    gsl_vector_free(d);
-    gsl_vector_free(e);
-    gsl_vector_free(b);
-
-    if (result) {
-      free(*y2);
-      *y2 = 0;
-    }
-    else
-      return num_points;
+    return spline_tridiag_solve_parallel(c, d, e, b, workspace->w,
+      workspace->z, num_points, workspace->num_threads);
   }
   
-  return -SPLINE_ERROR_INTERPOLATION;
+  return SPLINE_ERROR_INTERPOLATION;
 }
 
-ssize_t spline_int_solve_symm_cyc_tridiag_y2(const spline_point_t* points,
-    size_t num_points, double d_1, double e_m, double b_1, double** y2) {
-  if (num_points > 2) {
-    *y2 = realloc(*y2, (num_points-1)*sizeof(double));
+int spline_int_workspace_symm_cyc_tridiag_y2(spline_workspace_t* workspace,
+    const spline_point_t* points, size_t num_points, double d_1, double e_m,
+    double b_1) {
+  if ((num_points > 2) &&
+      (spline_workspace_reserve(workspace, num_points-1) >= num_points-1)) {
     
-    gsl_vector* d = gsl_vector_alloc(num_points-1);
-    gsl_vector* e = gsl_vector_alloc(num_points-1);
-    gsl_vector_view x = gsl_vector_view_array(*y2, num_points-1);
-    gsl_vector* b = gsl_vector_alloc(num_points-1);
+    double* d = workspace->d;
+    double* e = workspace->e;
+    double* b = workspace->b;
     
-    gsl_vector_set(d, 0, d_1);
-    gsl_vector_set(b, 0, b_1);
+    d[0] = d_1;
+    b[0] = b_1;
     
     size_t i;
     double h_i, h_j = 0.0;
@@ -692,39 +1325,44 @@ ssize_t spline_int_solve_symm_cyc_tridiag_y2(const spline_point_t* points,
       h_i = (i > 1) ? h_j : points[i].x-points[i-1].x;
       h_j = points[i+1].x-points[i].x;
       
-      double d_i = 2.0*(h_i+h_j);
-      double e_i = h_i;
-      double b_i = 6.0*((points[i+1].y-points[i].y)/h_j-
+      d[i] = 2.0*(h_i+h_j);
+      e[i-1] = h_i;
+      b[i] = 6.0*((points[i+1].y-points[i].y)/h_j-
         (points[i].y-points[i-1].y)/h_i);
-      
-      gsl_vector_set(d, i, d_i);
-      gsl_vector_set(e, i-1, e_i);
-      gsl_vector_set(b, i, b_i);
     }
     
-    gsl_vector_set(e, num_points-2, e_m);
+    e[num_points-2] = e_m;
 
-    int result = gsl_linalg_solve_symm_cyc_tridiag(d, e, b, &x.vector);
-    
-    gsl_vector_free(d);
-    gsl_vector_free(e);
-    gsl_vector_free(b);
-    
-    if (result) {
-      free(*y2);
-      *y2 = 0;
-    }
-    else
-      return num_points-1;
-    
+    return spline_tridiag_solve_symm_cyc(d, e, b, workspace->w,
+      workspace->z, num_points-1);
   }
 
-  return -SPLINE_ERROR_INTERPOLATION;
+  return SPLINE_ERROR_INTERPOLATION;
 }
 
 double spline_eval(spline_t* spline, spline_eval_type_t eval_type, double x) {
-  return spline_eval_bisect(spline, eval_type, x, 0,
-    spline->num_knots > 1 ? spline->num_knots-1 : 0);
+  ssize_t i;
+  
+  if ((i = spline_find_segment(spline, x)) >= 0)
+    return spline_segment_eval(&spline_update_segments(spline)[i],
+      eval_type, x);
+  else
+    return NAN;
+}
+
+int spline_eval_r(const spline_t* spline, spline_eval_type_t eval_type,
+    double x, double* value) {
+  spline_segment_t segment;
+  ssize_t i;
+  
+  if ((i = spline_find_segment_r(spline, x)) >= 0) {
+    *value = spline_segment_eval(spline_get_segment_cached(spline, i,
+      &segment), eval_type, x);
+    return SPLINE_ERROR_NONE;
+  }
+  
+  *value = NAN;
+  return -i;
 }
 
 double spline_eval_bisect(spline_t* spline, spline_eval_type_t eval_type,
@@ -732,7 +1370,7 @@ double spline_eval_bisect(spline_t* spline, spline_eval_type_t eval_type,
   ssize_t i;
   
   if ((i = spline_find_segment_bisect(spline, x, index_min, index_max)) >= 0)
-    return spline_knot_eval(&spline->knots[i], &spline->knots[i+1],
+    return spline_segment_eval(&spline_update_segments(spline)[i],
       eval_type, x);
   else
     return NAN;
@@ -744,9 +1382,481 @@ double spline_eval_linear(spline_t* spline, spline_eval_type_t eval_type,
   
   if ((i = spline_find_segment_linear(spline, x, *index)) >= 0) {
     *index = i;
-    return spline_knot_eval(&spline->knots[i], &spline->knots[i+1],
+    return spline_segment_eval(&spline_update_segments(spline)[i],
       eval_type, x);
   }
   else
     return NAN;
 }
+
+int spline_eval_linear_r(const spline_t* spline, spline_eval_type_t
+    eval_type, double x, size_t* index, double* value) {
+  spline_segment_t segment;
+  ssize_t i;
+  
+  if ((i = spline_find_segment_adjacent(spline, x, *index)) >= 0) {
+    *index = i;
+    *value = spline_segment_eval(spline_get_segment_cached(spline, i,
+      &segment), eval_type, x);
+    return SPLINE_ERROR_NONE;
+  }
+  
+  *value = NAN;
+  return SPLINE_ERROR_UNDEFINED;
+}
+
+double spline_integrate(spline_t* spline, double a, double b) {
+  double integral;
+  
+  error_clear(&spline->error);
+  
+  spline_update_segments(spline);
+  spline_update_index(spline);
+  spline_update_integrals(spline);
+  
+  if (spline_integrate_r(spline, a, b, &integral))
+    error_setf(&spline->error, SPLINE_ERROR_UNDEFINED, "%lg",
+      (spline_find_segment_index(spline, a) < 0) ? a : b);
+  
+  return integral;
+}
+
+int spline_integrate_r(const spline_t* spline, double a, double b, double*
+    integral) {
+  spline_segment_t segment_i, segment_j, segment_k;
+  ssize_t i, j;
+  
+  if (((i = spline_find_segment_r(spline, a)) < 0) ||
+      ((j = spline_find_segment_r(spline, b)) < 0)) {
+    *integral = NAN;
+    return SPLINE_ERROR_UNDEFINED;
+  }
+  
+  const spline_segment_t* s_i = spline_get_segment_cached(spline, i,
+    &segment_i);
+  const spline_segment_t* s_j = spline_get_segment_cached(spline, j,
+    &segment_j);
+  
+  if (i == j)
+    *integral = spline_segment_integrate(s_i, a, b);
+  else {
+    double sum = 0.0;
+    
+    if ((i < spline->num_integrals) && (j < spline->num_integrals))
+      sum = spline->integrals[j]-spline->integrals[i];
+    else {
+      size_t k_min = (i < j) ? i : j, k_max = (i < j) ? j : i, k;
+      
+      for (k = k_min; k < k_max; ++k)
+        sum += spline_segment_integrate(spline_get_segment_cached(spline,
+          k, &segment_k), spline->knots[k].x, spline->knots[k+1].x);
+      if (j < i)
+        sum = -sum;
+    }
+    
+    *integral = sum+spline_segment_integrate(s_j, spline->knots[j].x, b)-
+      spline_segment_integrate(s_i, spline->knots[i].x, a);
+  }
+  
+  return SPLINE_ERROR_NONE;
+}
+
+size_t spline_solve(spline_t* spline, spline_eval_type_t eval_type, double y,
+    double* x, size_t max_roots) {
+  error_clear(&spline->error);
+  
+  spline_update_segments(spline);
+  spline_update_bounds(spline, eval_type);
+  
+  return spline_solve_r(spline, eval_type, y, x, max_roots);
+}
+
+size_t spline_solve_r(const spline_t* spline, spline_eval_type_t eval_type,
+    double y, double* x, size_t max_roots) {
+  size_t num_roots = 0;
+  
+  if (spline->num_knots < 2)
+    return 0;
+  
+  if (spline->num_bounds && (spline->bounds_type == eval_type)) {
+    const double* bounds = spline->bounds;
+    size_t num_leaves = spline->num_bounds;
+    size_t stack[16*sizeof(size_t)];
+    size_t num_nodes = 0;
+    
+    stack[num_nodes++] = 1;
+    while (num_nodes && (num_roots < max_roots)) {
+      size_t node = stack[--num_nodes];
+      
+      if ((y < bounds[2*node]) || (y > bounds[2*node+1]))
+        continue;
+      
+      if (node < num_leaves) {
+        stack[num_nodes++] = 2*node+1;
+        stack[num_nodes++] = 2*node;
+      }
+      else
+        num_roots = spline_solve_segment(spline, eval_type, y,
+          node-num_leaves, x, num_roots, max_roots);
+    }
+  }
+  else {
+    size_t i;
+    
+    for (i = 0; (i+1 < spline->num_knots) && (num_roots < max_roots); ++i)
+      num_roots = spline_solve_segment(spline, eval_type, y, i, x,
+        num_roots, max_roots);
+  }
+  
+  return num_roots;
+}
+
+size_t spline_solve_segment(const spline_t* spline, spline_eval_type_t
+    eval_type, double y, size_t index, double* x, size_t num_roots, size_t
+    max_roots) {
+  double x_min = spline->knots[index].x, x_max = spline->knots[index+1].x;
+  spline_segment_t segment;
+  double roots[3];
+  size_t i, num_segment_roots;
+  
+  num_segment_roots = spline_segment_solve(spline_get_segment_cached(spline,
+    index, &segment), eval_type, y, x_max, roots);
+  for (i = 0; (i < num_segment_roots) && (num_roots < max_roots); ++i) {
+    if (num_roots && (roots[i]-x[num_roots-1] <=
+        SPLINE_SOLVE_EPSILON*(x_max-x_min)))
+      continue;
+    x[num_roots++] = roots[i];
+  }
+  
+  return num_roots;
+}
+
+int spline_eval_derivatives(spline_t* spline, double x, double* y, double*
+    y1, double* y2) {
+  ssize_t i;
+  
+  if ((i = spline_find_segment(spline, x)) >= 0)
+    spline_segment_eval_derivatives(&spline_update_segments(spline)[i], x,
+      y, y1, y2);
+  else {
+    if (y)
+      *y = NAN;
+    if (y1)
+      *y1 = NAN;
+    if (y2)
+      *y2 = NAN;
+  }
+  
+  return spline->error.code;
+}
+
+int spline_eval_derivatives_r(const spline_t* spline, double x, double* y,
+    double* y1, double* y2) {
+  spline_segment_t segment;
+  ssize_t i;
+  
+  if ((i = spline_find_segment_r(spline, x)) >= 0) {
+    spline_segment_eval_derivatives(spline_get_segment_cached(spline, i,
+      &segment), x, y, y1, y2);
+    return SPLINE_ERROR_NONE;
+  }
+  
+  if (y)
+    *y = NAN;
+  if (y1)
+    *y1 = NAN;
+  if (y2)
+    *y2 = NAN;
+  
+  return -i;
+}
+
+size_t spline_eval_array(spline_t* spline, spline_eval_type_t eval_type,
+    const double* x, double* values, size_t num_values) {
+  size_t index = 0;
+  
+  return spline_eval_array_linear(spline, eval_type, x, values, num_values,
+    &index);
+}
+
+ssize_t spline_find_segment_adjacent(const spline_t* spline, double x,
+    size_t index) {
+  const spline_knot_t* knots = spline->knots;
+  size_t i, j;
+  
+  if ((spline->num_knots < 2) || !(x >= knots[0].x) ||
+      !(x <= knots[spline->num_knots-1].x))
+    return -1;
+  
+  if (index+1 >= spline->num_knots)
+    index = spline->num_knots-2;
+  
+  if (x >= knots[index].x) {
+    if (x <= knots[index+1].x)
+      return index;
+    else if ((index+2 < spline->num_knots) && (x <= knots[index+2].x))
+      return index+1;
+    
+    i = index+1;
+    j = spline->num_knots-1;
+  }
+  else {
+    if (index && (x >= knots[index-1].x))
+      return index-1;
+    
+    i = 0;
+    j = index;
+  }
+  
+  if (spline->num_buckets)
+    return spline_find_segment_index(spline, x);
+  
+  while (j-i > 1) {
+    size_t k = (i+j) >> 1;
+    if (knots[k].x > x)
+      j = k;
+    else
+      i = k;
+  }
+  
+  return i;
+}
+
+void spline_eval_block(spline_eval_type_t eval_type, const double* x,
+    const double* a, const double* b, const double* c, const double* d,
+    const double* x_0, double* values, size_t num_values) {
+  size_t i = 0;
+  
+#ifdef SPLINE_SIMD_WIDTH
+  spline_simd_t two = spline_simd_set(2.0);
+  spline_simd_t three = spline_simd_set(3.0);
+  spline_simd_t six = spline_simd_set(6.0);
+  
+  for ( ; i+SPLINE_SIMD_WIDTH <= num_values; i += SPLINE_SIMD_WIDTH) {
+    spline_simd_t x_i = spline_simd_sub(spline_simd_load(&x[i]),
+      spline_simd_load(&x_0[i]));
+    spline_simd_t a_i = spline_simd_load(&a[i]);
+    spline_simd_t b_i = spline_simd_load(&b[i]);
+    spline_simd_t f_i;
+    
+    if (eval_type == spline_eval_type_first_derivative) {
+      f_i = spline_simd_mul(three, spline_simd_mul(a_i, x_i));
+      f_i = spline_simd_add(f_i, spline_simd_mul(two, b_i));
+      f_i = spline_simd_add(spline_simd_mul(f_i, x_i),
+        spline_simd_load(&c[i]));
+    }
+    else if (eval_type == spline_eval_type_second_derivative) {
+      f_i = spline_simd_mul(six, spline_simd_mul(a_i, x_i));
+      f_i = spline_simd_add(f_i, spline_simd_mul(two, b_i));
+    }
+    else {
+      f_i = spline_simd_add(spline_simd_mul(a_i, x_i), b_i);
+      f_i = spline_simd_add(spline_simd_mul(f_i, x_i),
+        spline_simd_load(&c[i]));
+      f_i = spline_simd_add(spline_simd_mul(f_i, x_i),
+        spline_simd_load(&d[i]));
+    }
+    
+    spline_simd_store(&values[i], f_i);
+  }
+#endif
+  
+  for ( ; i < num_values; ++i) {
+    spline_segment_t segment = {a[i], b[i], c[i], d[i], x_0[i]};
+    values[i] = spline_segment_eval(&segment, eval_type, x[i]);
+  }
+}
+
+size_t spline_eval_array_linear(spline_t* spline, spline_eval_type_t
+    eval_type, const double* x, double* values, size_t num_values, size_t*
+    index) {
+  size_t num_defined;
+  
+  error_clear(&spline->error);
+  spline_update_segments(spline);
+  spline_update_index(spline);
+  
+  num_defined = spline_eval_array_linear_r(spline, eval_type, x, values,
+    num_values, index);
+  if (num_defined < num_values)
+    error_setf(&spline->error, SPLINE_ERROR_UNDEFINED, "%lg",
+      x[spline_find_undefined(spline, x, num_values)]);
+  
+  return num_defined;
+}
+
+size_t spline_eval_array_linear_r(const spline_t* spline, spline_eval_type_t
+    eval_type, const double* x, double* values, size_t num_values, size_t*
+    index) {
+  double x_b[SPLINE_EVAL_BLOCK_SIZE], f_b[SPLINE_EVAL_BLOCK_SIZE];
+  double a[SPLINE_EVAL_BLOCK_SIZE], b[SPLINE_EVAL_BLOCK_SIZE];
+  double c[SPLINE_EVAL_BLOCK_SIZE], d[SPLINE_EVAL_BLOCK_SIZE];
+  double x_0[SPLINE_EVAL_BLOCK_SIZE];
+  size_t o_b[SPLINE_EVAL_BLOCK_SIZE];
+  spline_segment_t cached;
+  size_t i, j, num_defined = 0;
+  
+  for (i = 0; i < num_values; i += SPLINE_EVAL_BLOCK_SIZE) {
+    size_t num_block = 0;
+    
+    for (j = i; (j < num_values) && (j < i+SPLINE_EVAL_BLOCK_SIZE); ++j) {
+      ssize_t k = spline_find_segment_adjacent(spline, x[j], *index);
+      
+      if (k >= 0) {
+        const spline_segment_t* segment = spline_get_segment_cached(spline,
+          k, &cached);
+        
+        x_b[num_block] = x[j];
+        a[num_block] = segment->a;
+        b[num_block] = segment->b;
+        c[num_block] = segment->c;
+        d[num_block] = segment->d;
+        x_0[num_block] = segment->x_0;
+        o_b[num_block] = j;
+        
+        ++num_block;
+        *index = k;
+      }
+      else
+        values[j] = NAN;
+    }
+    
+    spline_eval_block(eval_type, x_b, a, b, c, d, x_0, f_b, num_block);
+    for (j = 0; j < num_block; ++j)
+      values[o_b[j]] = f_b[j];
+    
+    num_defined += num_block;
+  }
+  
+  return num_defined;
+}
+
+size_t spline_eval_array_derivatives(spline_t* spline, const double* x,
+    double* y, double* y1, double* y2, size_t num_values) {
+  size_t index = 0;
+  
+  return spline_eval_array_linear_derivatives(spline, x, y, y1, y2,
+    num_values, &index);
+}
+
+void spline_eval_block_derivatives(const double* x, const double* a,
+    const double* b, const double* c, const double* d, const double* x_0,
+    double* y, double* y1, double* y2, size_t num_values) {
+  size_t i = 0;
+  
+#ifdef SPLINE_SIMD_WIDTH
+  spline_simd_t two = spline_simd_set(2.0);
+  spline_simd_t three = spline_simd_set(3.0);
+  spline_simd_t six = spline_simd_set(6.0);
+  
+  for ( ; i+SPLINE_SIMD_WIDTH <= num_values; i += SPLINE_SIMD_WIDTH) {
+    spline_simd_t x_i = spline_simd_sub(spline_simd_load(&x[i]),
+      spline_simd_load(&x_0[i]));
+    spline_simd_t a_x = spline_simd_mul(spline_simd_load(&a[i]), x_i);
+    spline_simd_t b_i = spline_simd_load(&b[i]);
+    spline_simd_t c_i = spline_simd_load(&c[i]);
+    spline_simd_t two_b = spline_simd_mul(two, b_i);
+    spline_simd_t f_i;
+    
+    if (y) {
+      f_i = spline_simd_add(spline_simd_mul(spline_simd_add(a_x, b_i), x_i),
+        c_i);
+      f_i = spline_simd_add(spline_simd_mul(f_i, x_i),
+        spline_simd_load(&d[i]));
+      spline_simd_store(&y[i], f_i);
+    }
+    if (y1) {
+      f_i = spline_simd_add(spline_simd_mul(three, a_x), two_b);
+      f_i = spline_simd_add(spline_simd_mul(f_i, x_i), c_i);
+      spline_simd_store(&y1[i], f_i);
+    }
+    if (y2) {
+      f_i = spline_simd_add(spline_simd_mul(six, a_x), two_b);
+      spline_simd_store(&y2[i], f_i);
+    }
+  }
+#endif
+  
+  for ( ; i < num_values; ++i) {
+    spline_segment_t segment = {a[i], b[i], c[i], d[i], x_0[i]};
+    spline_segment_eval_derivatives(&segment, x[i], y ? &y[i] : 0,
+      y1 ? &y1[i] : 0, y2 ? &y2[i] : 0);
+  }
+}
+
+size_t spline_eval_array_linear_derivatives(spline_t* spline, const double*
+    x, double* y, double* y1, double* y2, size_t num_values, size_t* index) {
+  size_t num_defined;
+  
+  error_clear(&spline->error);
+  spline_update_segments(spline);
+  spline_update_index(spline);
+  
+  num_defined = spline_eval_array_linear_derivatives_r(spline, x, y, y1, y2,
+    num_values, index);
+  if (num_defined < num_values)
+    error_setf(&spline->error, SPLINE_ERROR_UNDEFINED, "%lg",
+      x[spline_find_undefined(spline, x, num_values)]);
+  
+  return num_defined;
+}
+
+size_t spline_eval_array_linear_derivatives_r(const spline_t* spline, const
+    double* x, double* y, double* y1, double* y2, size_t num_values, size_t*
+    index) {
+  double x_b[SPLINE_EVAL_BLOCK_SIZE], y_b[SPLINE_EVAL_BLOCK_SIZE];
+  double y1_b[SPLINE_EVAL_BLOCK_SIZE], y2_b[SPLINE_EVAL_BLOCK_SIZE];
+  double a[SPLINE_EVAL_BLOCK_SIZE], b[SPLINE_EVAL_BLOCK_SIZE];
+  double c[SPLINE_EVAL_BLOCK_SIZE], d[SPLINE_EVAL_BLOCK_SIZE];
+  double x_0[SPLINE_EVAL_BLOCK_SIZE];
+  size_t o_b[SPLINE_EVAL_BLOCK_SIZE];
+  spline_segment_t cached;
+  size_t i, j, num_defined = 0;
+  
+  for (i = 0; i < num_values; i += SPLINE_EVAL_BLOCK_SIZE) {
+    size_t num_block = 0;
+    
+    for (j = i; (j < num_values) && (j < i+SPLINE_EVAL_BLOCK_SIZE); ++j) {
+      ssize_t k = spline_find_segment_adjacent(spline, x[j], *index);
+      
+      if (k >= 0) {
+        const spline_segment_t* segment = spline_get_segment_cached(spline,
+          k, &cached);
+        
+        x_b[num_block] = x[j];
+        a[num_block] = segment->a;
+        b[num_block] = segment->b;
+        c[num_block] = segment->c;
+        d[num_block] = segment->d;
+        x_0[num_block] = segment->x_0;
+        o_b[num_block] = j;
+        
+        ++num_block;
+        *index = k;
+      }
+      else {
+        if (y)
+          y[j] = NAN;
+        if (y1)
+          y1[j] = NAN;
+        if (y2)
+          y2[j] = NAN;
+      }
+    }
+    
+    spline_eval_block_derivatives(x_b, a, b, c, d, x_0, y ? y_b : 0,
+      y1 ? y1_b : 0, y2 ? y2_b : 0, num_block);
+    for (j = 0; j < num_block; ++j) {
+      if (y)
+        y[o_b[j]] = y_b[j];
+      if (y1)
+        y1[o_b[j]] = y1_b[j];
+      if (y2)
+        y2[o_b[j]] = y2_b[j];
+    }
+    
+    num_defined += num_block;
+  }
+  
+  return num_defined;
+}
@@ -47,6 +47,8 @@
 #include "spline/knot.h"
 #include "spline/segment.h"
 #include "spline/eval_type.h"
+#include "spline/int_type.h"
+#include "spline/workspace.h"
 
 #include "error/error.h"
 
@@ -68,6 +70,10 @@
 //!< Spline undefined at value
 #define SPLINE_ERROR_INTERPOLATION         6
 //!< Spline interpolation failed
+#define SPLINE_ERROR_FILE_CHECKSUM         7
+//!< Spline file checksum mismatch
+#define SPLINE_ERROR_CHANNELS              8
+//!< Invalid number of spline curve channels
 //@}
 
 /** \brief Predefined spline error descriptions
@@ -78,11 +84,60 @@ struct spline_segment_t;
 
 /** \brief Structure defining the spline
   * \note The first spline segment is assumed to start at zero.
+  * 
+  * In addition to its knots, the spline maintains a cache of segment
+  * coefficients and a segment lookup index, both of which are built lazily
+  * upon evaluation. Similarly, a table of cumulative segment integrals is
+  * built upon integration and a tree of segment bounds upon solving. The
+  * lookup index subdivides the spline's domain into buckets of equal
+  * width, each bucket referring to the range of segments it overlaps. The
+  * cached data is invalidated by any of the spline's modifying functions.
+  * 
+  * The interpolation functions solve their systems of equations in the
+  * workspace carried by the spline and store the resulting knots in an
+  * array of geometrically growing capacity. Since the workspace is retained
+  * until the spline is destroyed, repeated interpolations of similarly
+  * sized data will not allocate memory.
+  * 
+  * The knots and cached segments of a spline loaded by spline_map() refer
+  * to a private memory mapping of the spline file. Modifications of a
+  * mapped spline will never be written back to the file. Before any
+  * re-allocation of its knots or segments, the spline copies them to
+  * the heap and releases the mapping.
+  * 
+  * Since the caches are built upon demand, all functions operating on the
+  * spline may modify it. The reentrant functions suffixed with _r instead
+  * take a constant spline, never modify its error, and report errors by
+  * their return value. They use the spline's cached data where valid
+  * and otherwise derive segments from the knots on the fly. Once prepared
+  * by spline_prepare(), a spline may thus be shared for concurrent queries
+  * by any number of threads without locking, as long as it is not
+  * modified.
   */
 typedef struct spline_t {
   spline_knot_t* knots;       //!< The knots of the spline.
   size_t num_knots;           //!< The number of spline knots.
+  size_t capacity;            //!< The number of allocated spline knots.
 
+  spline_segment_t* segments; //!< The cached segments of the spline.
+  size_t num_segments;        //!< The number of valid cached segments.
+  
+  size_t* index;              //!< The segment lookup index of the spline.
+  size_t num_buckets;         //!< The number of valid lookup index buckets.
+  double bucket_scale;        //!< The inverse bucket width or zero.
+  
+  double* integrals;          //!< The cumulative integrals at the knots.
+  size_t num_integrals;       //!< The number of valid cumulative integrals.
+  
+  double* bounds;             //!< The tree of minimum and maximum values.
+  size_t num_bounds;          //!< The number of valid leaves of the tree.
+  spline_eval_type_t bounds_type; //!< The evaluation type of the bounds.
+  
+  spline_workspace_t workspace; //!< The interpolation workspace.
+  
+  void* map;                  //!< The memory-mapped file of the spline.
+  size_t map_size;            //!< The size of the memory-mapped file.
+  
   error_t error;              //!< The most recent spline error.
 } spline_t;
 
@@ -104,6 +159,62 @@ void spline_destroy(
 void spline_clear(
   spline_t* spline);
 
+/** \brief Invalidate the cached data of a cubic spline
+  * \param[in] spline The cubic spline to invalidate the cached data for.
+  * 
+  * The cached data of the spline, such as its segment coefficients and
+  * its segment lookup index, will be rebuilt upon the next evaluation.
+  * This function must be called whenever the knots of the spline are
+  * modified directly.
+  */
+void spline_invalidate(
+  spline_t* spline);
+
+/** \brief Invalidate the cached data depending on some knots of a cubic
+  *   spline
+  * \param[in] spline The cubic spline to invalidate the cached data for.
+  * \param[in] index The index of the first modified knot of the spline.
+  * 
+  * Unlike spline_invalidate(), this function retains the cached segments
+  * preceding the modified knots, such that only the remaining segments
+  * will be rebuilt upon the next evaluation. This function must be called
+  * whenever the knots of the spline are modified directly.
+  */
+void spline_invalidate_knots(
+  spline_t* spline,
+  size_t index);
+
+/** \brief Prepare the cached data of a cubic spline
+  * \param[in] spline The cubic spline to prepare the cached data for.
+  * 
+  * This function builds the spline's segment coefficients, its segment
+  * lookup index, its table of cumulative segment integrals, and its tree
+  * of segment bounds for the base function, unless they are valid. It
+  * should be called before the spline is shared among threads for queries
+  * through the reentrant functions, which will then perform as their
+  * non-reentrant counterparts.
+  */
+void spline_prepare(
+  spline_t* spline);
+
+/** \brief Reserve knots of a cubic spline
+  * \note Calling this function may invalidate previously acquired knot
+  *   pointers.
+  * \param[in] spline The cubic spline to reserve the knots for.
+  * \param[in] num_knots The requested number of knots of the spline.
+  * \return The resulting capacity of the spline.
+  * 
+  * If the capacity of the spline is smaller than requested, its knots
+  * will be re-allocated to at least twice their previous capacity and
+  * the cached data of the spline will be invalidated. The number of knots
+  * of the spline remains unchanged. If the re-allocation fails, the
+  * capacity of the spline remains unchanged as well, such that callers
+  * must compare the result against the requested number of knots.
+  */
+size_t spline_reserve_knots(
+  spline_t* spline,
+  size_t num_knots);
+
 /** \brief Retrieve the cubic spline's number of segments
   * \param[in] spline The cubic spline to retrieve the number of
   *   segments for.
@@ -124,25 +235,63 @@ size_t spline_get_num_segments(
   *   segment with the given index. If no such segment exists, it will
   *   not be modified.
   * \return The resulting error code.
+  * 
+  * The segment will be retrieved from the cache of segment coefficients,
+  * which is built if necessary.
   */
 int spline_get_segment(
   spline_t* spline,
   size_t index,
   struct spline_segment_t* segment);
 
+/** \brief Retrieve segment of the cubic spline (reentrant version)
+  * \param[in] spline The constant cubic spline to retrieve the segment for.
+  * \param[in] index The index of the cubic spline segment to be retrieved.
+  * \param[in,out] segment The segment to receive the cubic spline
+  *   segment with the given index. If no such segment exists, it will
+  *   not be modified.
+  * \return The resulting error code.
+  * 
+  * Unlike spline_get_segment(), this function derives the segment from
+  * the spline knots if the segment is not cached.
+  */
+int spline_get_segment_r(
+  const spline_t* spline,
+  size_t index,
+  struct spline_segment_t* segment);
+
 /** \brief Find segment of the cubic spline at a given location
   * \param[in] spline The cubic spline to be searched for the segment.
   * \param[in] x The location to find the spline segment for.
   * \return The index of the cubic spline segment at the given location
   *   or the negative error code if no such segment exists.
   * 
-  * This is a convenience function which searches the entire spline by
-  * means of the function spline_find_segment_bisect().
+  * This function searches the entire spline by means of its segment
+  * lookup index, which is built if necessary. The lookup index maps the
+  * location to a bucket of segments in constant time. Within this bucket,
+  * the segment is then identified by bisection. For uniformly or nearly
+  * uniformly spaced knots, the search is thus effectively performed in
+  * O(1) computational time.
   */
 ssize_t spline_find_segment(
   spline_t* spline,
   double x);
 
+/** \brief Find segment of the cubic spline at a given location (reentrant
+  *   version)
+  * \param[in] spline The constant cubic spline to be searched for the
+  *   segment.
+  * \param[in] x The location to find the spline segment for.
+  * \return The index of the cubic spline segment at the given location
+  *   or the negative error code if no such segment exists.
+  * 
+  * The spline is searched by means of its segment lookup index if valid
+  * or by bisection otherwise.
+  */
+ssize_t spline_find_segment_r(
+  const spline_t* spline,
+  double x);
+
 /** \brief Find segment of the cubic spline at a given location using
  *    bisection
   * \param[in] spline The cubic spline to be searched for the segment.
@@ -222,6 +371,63 @@ int spline_write(
   const char* filename,
   spline_t* spline);
 
+/** \brief Read cubic spline from binary file
+  * \note Calling this function may invalidate previously acquired knot
+  *   pointers.
+  * \param[in] filename The name of the binary file containing the cubic
+  *   spline. The special filename '-' indicates that the cubic spline shall
+  *   be read from stdin.
+  * \param[in,out] spline The read cubic spline.
+  * \return The number of spline knots read from the file or the negative
+  *   error code.
+  * 
+  * The spline knots and, if present in the file, the cached spline
+  * segments will be re-allocated to accommodate the read file content.
+  * The checksum of the file content is verified.
+  */
+int spline_read_binary(
+  const char* filename,
+  spline_t* spline);
+
+/** \brief Write cubic spline to binary file
+  * \param[in] filename The name of the binary file the cubic spline will
+  *   be written to. The special filename '-' indicates that the cubic
+  *   spline shall be written to stdout.
+  * \param[in] spline The cubic spline to be written.
+  * \param[in] segments If non-zero, the cached segments of the cubic
+  *   spline will be written along with its knots.
+  * \return The number of spline knots written to the file or the negative
+  *   error code.
+  * 
+  * See spline/binary.h for a description of the binary file format.
+  */
+int spline_write_binary(
+  const char* filename,
+  spline_t* spline,
+  int segments);
+
+/** \brief Memory-map cubic spline from binary file
+  * \note Calling this function may invalidate previously acquired knot
+  *   pointers.
+  * \param[in] filename The name of the uncompressed binary file containing
+  *   the cubic spline.
+  * \param[in,out] spline The mapped cubic spline.
+  * \param[in] verify If non-zero, the checksum of the file content will be
+  *   verified, requiring the entire file to be paged in.
+  * \return The number of spline knots mapped from the file or the negative
+  *   error code.
+  * 
+  * Instead of copying the file content, the spline knots and, if present
+  * in the file, the cached spline segments will refer to a private memory
+  * mapping of the file. Pages are thus loaded on demand and shared with
+  * other processes mapping the same file. The mapping is released when
+  * the spline is cleared or destroyed.
+  */
+int spline_map(
+  const char* filename,
+  spline_t* spline,
+  int verify);
+
 /** \brief Add knot to the cubic spline
   * \note Calling this function may invalidate previously acquired knot
   *   pointers.
@@ -229,12 +435,13 @@ int spline_write(
   * \param[in] knot The spline knot to be added to the cubic spline.
   * \return The number of knots in the resulting cubic spline.
   * 
-  * The spline knots will be re-allocated to accommodate the added knot.
-  * Since the spline is represented by a sequence of knots, sorted
-  * increasingly by their location, the added knot may have to be inserted
-  * into this sequence such as to obey the required ordering. If a knot
-  * with the same location is found in the spline, the added knot will
-  * replace this knot.
+  * The spline knots will be re-allocated to accommodate the added knot,
+  * growing their capacity geometrically such as to provide amortized
+  * constant cost for appending knots. Since the spline is represented by
+  * a sequence of knots, sorted increasingly by their location, the added
+  * knot may have to be inserted into this sequence such as to obey the
+  * required ordering. If a knot with the same location is found in the
+  * spline, the added knot will replace this knot.
   */
 size_t spline_add_knot(
   spline_t* spline,
@@ -545,8 +752,8 @@ ssize_t spline_int_solve_symm_cyc_tridiag_y2(
   * \return The function value of the cubic spline at the given location
   *   or NaN if the spline is undefined at that location.
   * 
-  * This is a convenience function which evaluates the spline value by 
-  * means of the function spline_eval_bisect(), allowing for the 
+  * This is a convenience function which evaluates the spline value at
+  * the segment identified by spline_find_segment(), allowing for the 
   * corresponding segment to be searched on the entire spline.
   */
 double spline_eval(
@@ -554,6 +761,24 @@ double spline_eval(
   spline_eval_type_t eval_type,
   double x);
 
+/** \brief Evaluate the spline at a given location (reentrant version)
+  * \param[in] spline The constant cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the cubic spline.
+  * \param[out] value The pointer receiving the function value of the cubic
+  *   spline at the given location or NaN if the spline is undefined at
+  *   that location.
+  * \return The resulting error code.
+  * 
+  * The spline segment at the given location is identified by
+  * spline_find_segment_r().
+  */
+int spline_eval_r(
+  const spline_t* spline,
+  spline_eval_type_t eval_type,
+  double x,
+  double* value);
+
 /** \brief Evaluate the spline at a given location using bisection
   * \param[in] spline The cubic spline to be evaluated.
   * \param[in] eval_type The evaluation type to be used.
@@ -567,7 +792,9 @@ double spline_eval(
   * 
   * This method calls the function spline_find_segment_bisect() in order
   * to identify the spline segment at the given location. This is optimal
-  * if sequential calls to this function involve random locations.
+  * if sequential calls to this function involve random locations. The
+  * segment's polynomial is then evaluated from the cached segment
+  * coefficients.
   */
 double spline_eval_bisect(
   spline_t* spline,
@@ -590,7 +817,8 @@ double spline_eval_bisect(
   * This method calls the function spline_find_segment_linear() in order
   * to identify the spline segment at the given location. This is optimal
   * if sequential calls to this function involve incremental or decremental
-  * locations.
+  * locations. The segment's polynomial is then evaluated from the cached
+  * segment coefficients.
   */
 double spline_eval_linear(
   spline_t* spline,
@@ -598,4 +826,350 @@ double spline_eval_linear(
   double x,
   size_t* index);
 
+/** \brief Evaluate the spline at a given location using linear search
+  *   (reentrant version)
+  * \param[in] spline The constant cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the cubic spline.
+  * \param[in,out] index The segment index at which to start with the
+  *   search. On return, the index will be modified to indicate the spline
+  *   segment at the given location. If no such segment exists, the index
+  *   will not be modified.
+  * \param[out] value The pointer receiving the function value of the cubic
+  *   spline at the given location or NaN if the spline is undefined at
+  *   that location.
+  * \return The resulting error code.
+  * 
+  * The segments adjacent to the given index are examined first, such that
+  * sequential calls involving incremental or decremental locations are
+  * performed in constant time. Otherwise, the search falls back to the
+  * segment lookup index if valid or to bisection.
+  */
+int spline_eval_linear_r(
+  const spline_t* spline,
+  spline_eval_type_t eval_type,
+  double x,
+  size_t* index,
+  double* value);
+
+/** \brief Integrate the spline over a given interval
+  * \param[in] spline The cubic spline to be integrated.
+  * \param[in] a The lower bound of the interval of integration.
+  * \param[in] b The upper bound of the interval of integration.
+  * \return The definite integral of the cubic spline from a to b or NaN
+  *   if the spline is undefined at either bound. For b < a, the integral
+  *   will be negative.
+  * 
+  * The integral is computed in closed form from the antiderivatives of
+  * the spline segments at the bounds and the spline's table of cumulative
+  * segment integrals. This table is built in O(N) computational time if
+  * necessary, such that subsequent integrals are found in O(1) time by
+  * means of the spline's segment lookup index. Cached cumulative integrals
+  * preceding the knots modified through spline_invalidate_knots() are
+  * retained.
+  */
+double spline_integrate(
+  spline_t* spline,
+  double a,
+  double b);
+
+/** \brief Integrate the spline over a given interval (reentrant version)
+  * \param[in] spline The constant cubic spline to be integrated.
+  * \param[in] a The lower bound of the interval of integration.
+  * \param[in] b The upper bound of the interval of integration.
+  * \param[out] integral The pointer receiving the definite integral of the
+  *   cubic spline from a to b or NaN if the spline is undefined at either
+  *   bound.
+  * \return The resulting error code.
+  * 
+  * The spline's table of cumulative segment integrals is used where
+  * valid. Otherwise, the integrals of the segments between the bounds are
+  * accumulated in O(N) computational time.
+  */
+int spline_integrate_r(
+  const spline_t* spline,
+  double a,
+  double b,
+  double* integral);
+
+/** \brief Solve the spline for a given value
+  * \param[in] spline The cubic spline to be solved.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] y The value for which to solve the cubic spline.
+  * \param[out] x The array receiving the locations at which the cubic
+  *   spline attains the given value, in ascending order.
+  * \param[in] max_roots The maximum number of locations to be found.
+  * \return The number of locations found, which will not exceed the
+  *   maximum number of locations.
+  * 
+  * Depending on the evaluation type, the locations are the solutions of
+  * f(x) = y, f'(x) = y, or f''(x) = y. In particular, the extrema of the
+  * spline are found by solving its first derivative for zero.
+  * 
+  * The function maintains a binary tree of the minimum and maximum values
+  * attained by the spline segments for the requested evaluation type.
+  * This tree is built in O(N) computational time if necessary and allows
+  * the search to skip any range of segments which cannot contain a
+  * solution. Each remaining segment is solved by spline_segment_solve(),
+  * and the search terminates as soon as the maximum number of locations
+  * has been found. A monotonic spline is thus solved in O(log N) time.
+  * Locations shared by adjacent segments are reported once.
+  */
+size_t spline_solve(
+  spline_t* spline,
+  spline_eval_type_t eval_type,
+  double y,
+  double* x,
+  size_t max_roots);
+
+/** \brief Solve the spline for a given value (reentrant version)
+  * \param[in] spline The constant cubic spline to be solved.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] y The value for which to solve the cubic spline.
+  * \param[out] x The array receiving the locations at which the cubic
+  *   spline attains the given value, in ascending order.
+  * \param[in] max_roots The maximum number of locations to be found.
+  * \return The number of locations found, which will not exceed the
+  *   maximum number of locations.
+  * 
+  * The spline's tree of segment bounds is used if it is valid for the
+  * requested evaluation type. Otherwise, all segments are solved in
+  * sequence.
+  */
+size_t spline_solve_r(
+  const spline_t* spline,
+  spline_eval_type_t eval_type,
+  double y,
+  double* x,
+  size_t max_roots);
+
+/** \brief Evaluate the spline and its derivatives at a given location
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] x The location at which to evaluate the cubic spline.
+  * \param[out] y The pointer receiving the function value of the cubic
+  *   spline at the given location or null if the value is not requested.
+  * \param[out] y1 The pointer receiving the first derivative of the cubic
+  *   spline at the given location or null if it is not requested.
+  * \param[out] y2 The pointer receiving the second derivative of the cubic
+  *   spline at the given location or null if it is not requested.
+  * \return The resulting error code. If the spline is undefined at the
+  *   given location, the requested values will be set to NaN.
+  * 
+  * In contrast to separate calls to spline_eval() for the different
+  * evaluation types, this function searches the spline segment at the
+  * given location only once and evaluates all requested values by means
+  * of spline_segment_eval_derivatives().
+  */
+int spline_eval_derivatives(
+  spline_t* spline,
+  double x,
+  double* y,
+  double* y1,
+  double* y2);
+
+/** \brief Evaluate the spline and its derivatives at a given location
+  *   (reentrant version)
+  * \param[in] spline The constant cubic spline to be evaluated.
+  * \param[in] x The location at which to evaluate the cubic spline.
+  * \param[out] y The pointer receiving the function value of the cubic
+  *   spline at the given location or null if the value is not requested.
+  * \param[out] y1 The pointer receiving the first derivative of the cubic
+  *   spline at the given location or null if it is not requested.
+  * \param[out] y2 The pointer receiving the second derivative of the cubic
+  *   spline at the given location or null if it is not requested.
+  * \return The resulting error code. If the spline is undefined at the
+  *   given location, the requested values will be set to NaN.
+  */
+int spline_eval_derivatives_r(
+  const spline_t* spline,
+  double x,
+  double* y,
+  double* y1,
+  double* y2);
+
+/** \brief Evaluate the spline at an array of locations
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline. The locations may be provided in any order, but evaluation
+  *   is most efficient for sorted or clustered locations.
+  * \param[out] values The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations. Values at locations
+  *   for which the spline is undefined will be set to NaN.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * This is a convenience function which evaluates the spline values by
+  * means of the function spline_eval_array_linear(), starting with the
+  * first spline segment.
+  */
+size_t spline_eval_array(
+  spline_t* spline,
+  spline_eval_type_t eval_type,
+  const double* x,
+  double* values,
+  size_t num_values);
+
+/** \brief Evaluate the spline at an array of locations using linear search
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline.
+  * \param[out] values The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations. Values at locations
+  *   for which the spline is undefined will be set to NaN.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \param[in,out] index The segment index at which to start with the
+  *   search. On return, the index will be modified to indicate the spline
+  *   segment at the last location for which the spline is defined.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * The spline segments are searched starting from the segment found for
+  * the preceding location, such that sequences of incremental or decremental
+  * locations walk the spline segments monotonically. Whenever the segment
+  * is not adjacent to the preceding one, the search falls back to the
+  * spline's segment lookup index. Segment search and polynomial evaluation are
+  * performed blockwise, with the cached segment coefficients being
+  * evaluated by vectorized kernels where supported by the target
+  * architecture (AVX or SSE2).
+  * 
+  * In contrast to repeated calls to spline_eval_linear(), the spline error
+  * is cleared only once. If the spline is undefined at any of the provided
+  * locations, the error will indicate the first such location.
+  */
+size_t spline_eval_array_linear(
+  spline_t* spline,
+  spline_eval_type_t eval_type,
+  const double* x,
+  double* values,
+  size_t num_values,
+  size_t* index);
+
+/** \brief Evaluate the spline at an array of locations using linear search
+  *   (reentrant version)
+  * \param[in] spline The constant cubic spline to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline.
+  * \param[out] values The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations. Values at locations
+  *   for which the spline is undefined will be set to NaN.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \param[in,out] index The segment index at which to start with the
+  *   search. On return, the index will be modified to indicate the spline
+  *   segment at the last location for which the spline is defined.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * This function performs the blockwise search and evaluation of
+  * spline_eval_array_linear() without modifying the spline.
+  */
+size_t spline_eval_array_linear_r(
+  const spline_t* spline,
+  spline_eval_type_t eval_type,
+  const double* x,
+  double* values,
+  size_t num_values,
+  size_t* index);
+
+/** \brief Evaluate the spline and its derivatives at an array of locations
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline. The locations may be provided in any order, but evaluation
+  *   is most efficient for sorted or clustered locations.
+  * \param[out] y The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations or null if the
+  *   values are not requested.
+  * \param[out] y1 The array of size num_values receiving the first
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[out] y2 The array of size num_values receiving the second
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * This is a convenience function which evaluates the spline values by
+  * means of the function spline_eval_array_linear_derivatives(), starting
+  * with the first spline segment.
+  */
+size_t spline_eval_array_derivatives(
+  spline_t* spline,
+  const double* x,
+  double* y,
+  double* y1,
+  double* y2,
+  size_t num_values);
+
+/** \brief Evaluate the spline and its derivatives at an array of locations
+  *   using linear search
+  * \param[in] spline The cubic spline to be evaluated.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline.
+  * \param[out] y The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations or null if the
+  *   values are not requested.
+  * \param[out] y1 The array of size num_values receiving the first
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[out] y2 The array of size num_values receiving the second
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \param[in,out] index The segment index at which to start with the
+  *   search. On return, the index will be modified to indicate the spline
+  *   segment at the last location for which the spline is defined.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * Like spline_eval_array_linear(), this function searches and evaluates
+  * the spline segments blockwise. The segment coefficients gathered for a
+  * block are shared by all requested values. Values at locations for which
+  * the spline is undefined will be set to NaN.
+  */
+size_t spline_eval_array_linear_derivatives(
+  spline_t* spline,
+  const double* x,
+  double* y,
+  double* y1,
+  double* y2,
+  size_t num_values,
+  size_t* index);
+
+/** \brief Evaluate the spline and its derivatives at an array of locations
+  *   using linear search (reentrant version)
+  * \param[in] spline The constant cubic spline to be evaluated.
+  * \param[in] x The array of locations at which to evaluate the cubic
+  *   spline.
+  * \param[out] y The array of size num_values receiving the function
+  *   values of the cubic spline at the given locations or null if the
+  *   values are not requested.
+  * \param[out] y1 The array of size num_values receiving the first
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[out] y2 The array of size num_values receiving the second
+  *   derivatives of the cubic spline at the given locations or null if
+  *   they are not requested.
+  * \param[in] num_values The number of locations to evaluate the cubic
+  *   spline at.
+  * \param[in,out] index The segment index at which to start with the
+  *   search. On return, the index will be modified to indicate the spline
+  *   segment at the last location for which the spline is defined.
+  * \return The number of locations at which the spline is defined.
+  * 
+  * This function performs the blockwise search and evaluation of
+  * spline_eval_array_linear_derivatives() without modifying the spline.
+  */
+size_t spline_eval_array_linear_derivatives_r(
+  const spline_t* spline,
+  const double* x,
+  double* y,
+  double* y1,
+  double* y2,
+  size_t num_values,
+  size_t* index);
+
 #endif
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "stream.h"
+
+#include "spline/tridiag.h"
+
+void spline_stream_init(spline_stream_t* stream, size_t window) {
+  spline_init(&stream->spline);
+  stream->window = window ? window : SPLINE_STREAM_DEFAULT_WINDOW;
+  
+  thread_mutex_init(&stream->mutex);
+}
+
+void spline_stream_destroy(spline_stream_t* stream) {
+  spline_destroy(&stream->spline);
+  
+  thread_mutex_destroy(&stream->mutex);
+}
+
+void spline_stream_clear(spline_stream_t* stream) {
+  thread_mutex_lock(&stream->mutex);
+  spline_clear(&stream->spline);
+  thread_mutex_unlock(&stream->mutex);
+}
+
+ssize_t spline_stream_add_point(spline_stream_t* stream, const
+    spline_point_t* point) {
+  spline_t* spline = &stream->spline;
+  spline_knot_t knot;
+  ssize_t result;
+  
+  spline_knot_init(&knot, point->x, point->y, 0.0);
+  
+  thread_mutex_lock(&stream->mutex);
+  error_clear(&spline->error);
+  
+  if (!spline->num_knots || (spline->knots[spline->num_knots-1].x < knot.x)) {
+    spline_add_knot(spline, &knot);
+    
+    size_t n = spline->num_knots-1;
+    size_t k = (n > stream->window) ? n-stream->window : 1;
+    size_t m = n-k;
+    spline_workspace_t* workspace = &spline->workspace;
+    
+    if (!spline->error.code && (n > 1) &&
+        (spline_workspace_reserve(workspace, m) < m))
+      error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+    else if (!spline->error.code && (n > 1)) {
+      const spline_knot_t* knots = spline->knots;
+      double* c = workspace->c;
+      double* d = workspace->d;
+      double* e = workspace->e;
+      double* b = workspace->b;
+      
+      size_t i;
+      double h_i, h_j = 0.0;
+      for (i = 0; i < m; ++i) {
+        size_t j = k+i;
+        
+        h_i = i ? h_j : knots[j].x-knots[j-1].x;
+        h_j = knots[j+1].x-knots[j].x;
+        
+        if (i)
+          c[i-1] = h_i;
+        d[i] = 2.0*(h_i+h_j);
+        e[i] = h_j;
+        b[i] = 6.0*((knots[j+1].y-knots[j].y)/h_j-
+          (knots[j].y-knots[j-1].y)/h_i);
+      }
+      b[0] -= (knots[k].x-knots[k-1].x)*knots[k-1].y2;
+      
+      if (!spline_tridiag_solve(c, d, e, b, workspace->w, m)) {
+        for (i = 0; i < m; ++i)
+          spline->knots[k+i].y2 = b[i];
+        spline_invalidate_knots(spline, k);
+      }
+      else
+        error_set(&spline->error, SPLINE_ERROR_INTERPOLATION);
+    }
+  }
+  else
+    error_setf(&spline->error, SPLINE_ERROR_INTERPOLATION, "%lg", knot.x);
+  
+  result = spline->error.code ? -spline->error.code : spline->num_knots;
+  thread_mutex_unlock(&stream->mutex);
+  
+  return result;
+}
+
+double spline_stream_eval(spline_stream_t* stream, spline_eval_type_t
+    eval_type, double x) {
+  double result;
+  
+  thread_mutex_lock(&stream->mutex);
+  result = spline_eval_bisect(&stream->spline, eval_type, x, 0,
+    stream->spline.num_knots);
+  thread_mutex_unlock(&stream->mutex);
+  
+  return result;
+}
+
+size_t spline_stream_copy(spline_stream_t* stream, spline_t* spline) {
+  size_t i;
+  
+  spline->num_knots = 0;
+  spline_invalidate(spline);
+  
+  thread_mutex_lock(&stream->mutex);
+  for (i = 0; i < stream->spline.num_knots; ++i)
+    spline_add_knot(spline, &stream->spline.knots[i]);
+  thread_mutex_unlock(&stream->mutex);
+  
+  return spline->num_knots;
+}
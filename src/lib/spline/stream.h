@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_STREAM_H
+#define SPLINE_STREAM_H
+
+/** \file spline/stream.h
+  * \ingroup spline
+  * \brief Streaming cubic spline construction
+  * \author Ralf Kaestner
+  * 
+  * A spline stream incrementally constructs a natural cubic spline from
+  * data points arriving in increasing order of their location, e.g., from
+  * a sensor. The streamed spline may be evaluated concurrently with the
+  * addition of points.
+  */
+
+#include "spline/spline.h"
+
+#include "thread/mutex.h"
+
+/** \brief The default window size of a spline stream
+  */
+#define SPLINE_STREAM_DEFAULT_WINDOW          32
+
+/** \brief Structure defining a spline stream
+  * 
+  * For each point appended to the stream, the second derivatives of the
+  * spline are updated within a sliding window covering the most recent
+  * knots only. The update solves the natural spline interpolation problem
+  * for the window, with the second derivative at the knot preceding the
+  * window held fixed. Since the influence of the added point decays
+  * geometrically with the distance in knots, the resulting spline closely
+  * approximates the natural spline through all points, whereas the cost
+  * of appending a point is bounded by the window size.
+  */
+typedef struct spline_stream_t {
+  spline_t spline;              //!< The streamed cubic spline.
+  size_t window;                //!< The number of knots updated per point.
+
+  thread_mutex_t mutex;         //!< The mutex guarding the spline.
+} spline_stream_t;
+
+/** \brief Initialize an empty spline stream
+  * \param[in] stream The spline stream to be initialized.
+  * \param[in] window The number of most recent knots whose second
+  *   derivatives are updated when a point is appended. A window of zero
+  *   will be replaced by SPLINE_STREAM_DEFAULT_WINDOW.
+  */
+void spline_stream_init(
+  spline_stream_t* stream,
+  size_t window);
+
+/** \brief Destroy a spline stream
+  * \param[in] stream The spline stream to be destroyed.
+  */
+void spline_stream_destroy(
+  spline_stream_t* stream);
+
+/** \brief Clear a spline stream
+  * \param[in] stream The spline stream to be cleared.
+  */
+void spline_stream_clear(
+  spline_stream_t* stream);
+
+/** \brief Append a data point to a spline stream
+  * \param[in] stream The spline stream to append the data point to.
+  * \param[in] point The data point to be appended. Its location must be
+  *   greater than the location of the last knot of the streamed spline.
+  * \return The number of knots in the streamed spline or the negative
+  *   error code.
+  * 
+  * The point is appended as a knot with zero second derivative, before
+  * the second derivatives within the stream's window are updated. The
+  * cached segments of the spline preceding the window are retained.
+  */
+ssize_t spline_stream_add_point(
+  spline_stream_t* stream,
+  const spline_point_t* point);
+
+/** \brief Evaluate a spline stream at a given location
+  * \param[in] stream The spline stream to be evaluated.
+  * \param[in] eval_type The evaluation type to be used.
+  * \param[in] x The location at which to evaluate the streamed spline.
+  * \return The function value of the streamed spline at the given location
+  *   or NaN if the spline is undefined at that location.
+  * 
+  * The segment containing the location is found by bisection, such that
+  * the evaluation does not require the spline's lookup index to be rebuilt
+  * after each appended point.
+  */
+double spline_stream_eval(
+  spline_stream_t* stream,
+  spline_eval_type_t eval_type,
+  double x);
+
+/** \brief Copy the spline of a spline stream
+  * \param[in] stream The spline stream to copy the spline from.
+  * \param[in,out] spline The initialized cubic spline receiving a copy of
+  *   the knots of the streamed spline.
+  * \return The number of knots in the copied spline.
+  * 
+  * Copying provides a consistent snapshot of the streamed spline which
+  * may be evaluated without locking while points are being appended.
+  */
+size_t spline_stream_copy(
+  spline_stream_t* stream,
+  spline_t* spline);
+
+#endif
@@ -0,0 +1,352 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "tridiag.h"
+
+#include "spline/spline.h"
+
+#include "thread/thread.h"
+
+void* spline_tridiag_eliminate(void* arg);
+void* spline_tridiag_substitute(void* arg);
+
+int spline_tridiag_solve(const double* c, const double* d, const double* e,
+    double* b, double* w, size_t n) {
+  size_t i;
+  double m;
+
+  if (!n || (d[0] == 0.0))
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  w[0] = (n > 1) ? e[0]/d[0] : 0.0;
+  b[0] /= d[0];
+  
+  for (i = 1; i < n; ++i) {
+    if ((m = d[i]-c[i-1]*w[i-1]) == 0.0)
+      return SPLINE_ERROR_INTERPOLATION;
+    
+    w[i] = (i+1 < n) ? e[i]/m : 0.0;
+    b[i] = (b[i]-c[i-1]*b[i-1])/m;
+  }
+  
+  for (i = n-1; i > 0; --i)
+    b[i-1] -= w[i-1]*b[i];
+  
+  return SPLINE_ERROR_NONE;
+}
+
+int spline_tridiag_solve_parallel(const double* c, const double* d, const
+    double* e, double* b, double* w, double* z, size_t n, size_t
+    num_threads) {
+  spline_tridiag_partition_t partitions[SPLINE_TRIDIAG_MAX_THREADS];
+  thread_t threads[SPLINE_TRIDIAG_MAX_THREADS];
+  int started[SPLINE_TRIDIAG_MAX_THREADS];
+  
+  double reduced[5*2*SPLINE_TRIDIAG_MAX_THREADS];
+  double* reduced_c = reduced;
+  double* reduced_d = &reduced_c[2*SPLINE_TRIDIAG_MAX_THREADS];
+  double* reduced_e = &reduced_d[2*SPLINE_TRIDIAG_MAX_THREADS];
+  double* reduced_b = &reduced_e[2*SPLINE_TRIDIAG_MAX_THREADS];
+  double* reduced_w = &reduced_b[2*SPLINE_TRIDIAG_MAX_THREADS];
+  
+  size_t num_partitions = n/SPLINE_TRIDIAG_MIN_PARTITION_SIZE;
+  if (num_partitions > num_threads)
+    num_partitions = num_threads;
+  if (num_partitions > SPLINE_TRIDIAG_MAX_THREADS)
+    num_partitions = SPLINE_TRIDIAG_MAX_THREADS;
+  
+  if (num_partitions < 2)
+    return spline_tridiag_solve(c, d, e, b, w, n);
+  
+  size_t i;
+  for (i = 0; i < num_partitions; ++i) {
+    spline_tridiag_partition_t* partition = &partitions[i];
+    
+    partition->c = c;
+    partition->d = d;
+    partition->e = e;
+    partition->b = b;
+    partition->w = w;
+    partition->z = z;
+    partition->n = n;
+    
+    partition->start = i*n/num_partitions;
+    partition->end = (i+1)*n/num_partitions-1;
+    
+    partition->reduced_c = reduced_c;
+    partition->reduced_d = reduced_d;
+    partition->reduced_e = reduced_e;
+    partition->reduced_b = reduced_b;
+    partition->index = i;
+    
+    partition->result = SPLINE_ERROR_NONE;
+  }
+  
+  for (i = 1; i < num_partitions; ++i)
+    started[i] = !thread_start(&threads[i], spline_tridiag_eliminate, 0,
+      &partitions[i], 0.0);
+  spline_tridiag_eliminate(&partitions[0]);
+  
+  int result = partitions[0].result;
+  for (i = 1; i < num_partitions; ++i) {
+    if (started[i])
+      thread_wait_exit(&threads[i]);
+    else
+      spline_tridiag_eliminate(&partitions[i]);
+    
+    if (partitions[i].result)
+      result = partitions[i].result;
+  }
+  
+  if (!result)
+    result = spline_tridiag_solve(reduced_c, reduced_d, reduced_e,
+      reduced_b, reduced_w, 2*num_partitions);
+  if (result)
+    return result;
+  
+  for (i = 1; i < num_partitions; ++i)
+    started[i] = !thread_start(&threads[i], spline_tridiag_substitute, 0,
+      &partitions[i], 0.0);
+  spline_tridiag_substitute(&partitions[0]);
+  
+  for (i = 1; i < num_partitions; ++i) {
+    if (started[i])
+      thread_wait_exit(&threads[i]);
+    else
+      spline_tridiag_substitute(&partitions[i]);
+  }
+  
+  return SPLINE_ERROR_NONE;
+}
+
+int spline_tridiag_solve_symm_cyc(const double* d, const double* e,
+    double* b, double* w, double* z, size_t n) {
+  size_t i;
+  double m;
+
+  if ((n < 2) || (d[0] == 0.0))
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  double gamma = -d[0];
+  double alpha = e[n-1];
+  double d_n = d[n-1]-alpha*alpha/gamma;
+  
+  m = d[0]-gamma;
+  w[0] = e[0]/m;
+  b[0] /= m;
+  z[0] = gamma/m;
+  
+  for (i = 1; i < n; ++i) {
+    if ((m = ((i+1 < n) ? d[i] : d_n)-e[i-1]*w[i-1]) == 0.0)
+      return SPLINE_ERROR_INTERPOLATION;
+    
+    w[i] = (i+1 < n) ? e[i]/m : 0.0;
+    b[i] = (b[i]-e[i-1]*b[i-1])/m;
+    z[i] = (((i+1 < n) ? 0.0 : alpha)-e[i-1]*z[i-1])/m;
+  }
+  
+  for (i = n-1; i > 0; --i) {
+    b[i-1] -= w[i-1]*b[i];
+    z[i-1] -= w[i-1]*z[i];
+  }
+  
+  if ((m = 1.0+z[0]+alpha*z[n-1]/gamma) == 0.0)
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  double f = (b[0]+alpha*b[n-1]/gamma)/m;
+  for (i = 0; i < n; ++i)
+    b[i] -= f*z[i];
+  
+  return SPLINE_ERROR_NONE;
+}
+
+int spline_tridiag_factor(const double* c, const double* d, const double* e,
+    double* w, double* m, size_t n) {
+  size_t i;
+  double p;
+  
+  if (!n || (d[0] == 0.0))
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  m[0] = 1.0/d[0];
+  w[0] = (n > 1) ? e[0]*m[0] : 0.0;
+  
+  for (i = 1; i < n; ++i) {
+    if ((p = d[i]-c[i-1]*w[i-1]) == 0.0)
+      return SPLINE_ERROR_INTERPOLATION;
+    
+    m[i] = 1.0/p;
+    w[i] = (i+1 < n) ? e[i]*m[i] : 0.0;
+  }
+  
+  return SPLINE_ERROR_NONE;
+}
+
+void spline_tridiag_solve_factor(const double* c, const double* w, const
+    double* m, double* b, size_t n, size_t num_rhs, size_t stride) {
+  size_t i, k;
+  
+  if (!n)
+    return;
+  
+  for (k = 0; k < num_rhs; ++k)
+    b[k*stride] *= m[0];
+  
+  for (i = 1; i < n; ++i)
+    for (k = 0; k < num_rhs; ++k) {
+      double* b_k = &b[k*stride];
+      b_k[i] = (b_k[i]-c[i-1]*b_k[i-1])*m[i];
+    }
+  
+  for (i = n-1; i > 0; --i)
+    for (k = 0; k < num_rhs; ++k) {
+      double* b_k = &b[k*stride];
+      b_k[i-1] -= w[i-1]*b_k[i];
+    }
+}
+
+int spline_tridiag_factor_symm_cyc(const double* d, const double* e,
+    double* w, double* m, double* z, size_t n) {
+  size_t i;
+  double p;
+
+  if ((n < 2) || (d[0] == 0.0))
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  double gamma = -d[0];
+  double alpha = e[n-1];
+  double d_n = d[n-1]-alpha*alpha/gamma;
+  
+  m[0] = 1.0/(d[0]-gamma);
+  w[0] = e[0]*m[0];
+  z[0] = gamma*m[0];
+  
+  for (i = 1; i < n; ++i) {
+    if ((p = ((i+1 < n) ? d[i] : d_n)-e[i-1]*w[i-1]) == 0.0)
+      return SPLINE_ERROR_INTERPOLATION;
+    
+    m[i] = 1.0/p;
+    w[i] = (i+1 < n) ? e[i]*m[i] : 0.0;
+    z[i] = (((i+1 < n) ? 0.0 : alpha)-e[i-1]*z[i-1])*m[i];
+  }
+  
+  for (i = n-1; i > 0; --i)
+    z[i-1] -= w[i-1]*z[i];
+  
+  if ((p = 1.0+z[0]+alpha*z[n-1]/gamma) == 0.0)
+    return SPLINE_ERROR_INTERPOLATION;
+  
+  for (i = 0; i < n; ++i)
+    z[i] /= p;
+  
+  return SPLINE_ERROR_NONE;
+}
+
+void spline_tridiag_solve_factor_symm_cyc(const double* d, const double* e,
+    const double* w, const double* m, const double* z, double* b, size_t n,
+    size_t num_rhs, size_t stride) {
+  size_t i, k;
+  
+  if (n < 2)
+    return;
+  
+  spline_tridiag_solve_factor(e, w, m, b, n, num_rhs, stride);
+  
+  double v = -e[n-1]/d[0];
+  for (k = 0; k < num_rhs; ++k) {
+    double* b_k = &b[k*stride];
+    double f = b_k[0]+v*b_k[n-1];
+    
+    for (i = 0; i < n; ++i)
+      b_k[i] -= f*z[i];
+  }
+}
+
+void* spline_tridiag_eliminate(void* arg) {
+  spline_tridiag_partition_t* partition = arg;
+  
+  const double* c = partition->c;
+  const double* d = partition->d;
+  const double* e = partition->e;
+  double* b = partition->b;
+  double* w = partition->w;
+  double* z = partition->z;
+  
+  size_t s = partition->start;
+  size_t t = partition->end;
+  size_t k = 2*partition->index;
+  size_t i;
+  double m = 0.0;
+  
+  partition->result = SPLINE_ERROR_INTERPOLATION;
+  
+  for (i = s+1; i < t; ++i) {
+    if ((m = (i > s+1) ? d[i]-c[i-1]*w[i-1] : d[i]) == 0.0)
+      return 0;
+    
+    w[i] = (i+1 < t) ? e[i]/m : -e[i]/m;
+    b[i] = (i > s+1) ? (b[i]-c[i-1]*b[i-1])/m : b[i]/m;
+    z[i] = (i > s+1) ? -c[i-1]*z[i-1]/m : -c[i-1]/m;
+  }
+  
+  for (i = t-2; i > s; --i) {
+    b[i] -= w[i]*b[i+1];
+    z[i] -= w[i]*z[i+1];
+    w[i] = -w[i]*w[i+1];
+  }
+  
+  if (s)
+    partition->reduced_c[k-1] = c[s-1];
+  partition->reduced_d[k] = d[s]+e[s]*z[s+1];
+  partition->reduced_e[k] = e[s]*w[s+1];
+  partition->reduced_b[k] = b[s]-e[s]*b[s+1];
+  
+  partition->reduced_c[k] = c[t-1]*z[t-1];
+  partition->reduced_d[k+1] = d[t]+c[t-1]*w[t-1];
+  if (t+1 < partition->n)
+    partition->reduced_e[k+1] = e[t];
+  partition->reduced_b[k+1] = b[t]-c[t-1]*b[t-1];
+  
+  partition->result = SPLINE_ERROR_NONE;
+  return 0;
+}
+
+void* spline_tridiag_substitute(void* arg) {
+  spline_tridiag_partition_t* partition = arg;
+  
+  double* b = partition->b;
+  double* w = partition->w;
+  double* z = partition->z;
+  
+  size_t s = partition->start;
+  size_t t = partition->end;
+  size_t i;
+  
+  double x_s = partition->reduced_b[2*partition->index];
+  double x_t = partition->reduced_b[2*partition->index+1];
+  
+  for (i = s+1; i < t; ++i)
+    b[i] += z[i]*x_s+w[i]*x_t;
+  
+  b[s] = x_s;
+  b[t] = x_t;
+  
+  return 0;
+}
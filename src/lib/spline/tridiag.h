@@ -0,0 +1,287 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_TRIDIAG_H
+#define SPLINE_TRIDIAG_H
+
+/** \file spline/tridiag.h
+  * \ingroup spline
+  * \brief Tridiagonal solvers for cubic spline interpolation
+  * \author Ralf Kaestner
+  * 
+  * The tridiagonal solvers provide the linear algebra underlying cubic
+  * spline interpolation. They operate in place on arrays provided by
+  * the caller and thus never allocate memory.
+  */
+
+#include <stdlib.h>
+
+/** \brief The maximum number of threads of the parallel tridiagonal solver
+  */
+#define SPLINE_TRIDIAG_MAX_THREADS            64
+
+/** \brief The minimum number of equations per thread of the parallel
+  *   tridiagonal solver
+  * 
+  * Smaller systems are solved serially, since the cost of starting the
+  * threads would exceed the gain from partitioning.
+  */
+#define SPLINE_TRIDIAG_MIN_PARTITION_SIZE     65536
+
+/** \brief Structure defining a partition of a tridiagonal system
+  * 
+  * A partition refers to a contiguous range of equations of a tridiagonal
+  * system processed by one thread of the parallel tridiagonal solver. It
+  * contributes the two equations in its first and last unknown to the
+  * reduced system of the solver.
+  */
+typedef struct spline_tridiag_partition_t {
+  const double* c;              //!< The lower sub-diagonal of the system.
+  const double* d;              //!< The main diagonal of the system.
+  const double* e;              //!< The upper sub-diagonal of the system.
+  double* b;                    //!< The right-hand side and the solution.
+  double* w;                    //!< The first workspace array.
+  double* z;                    //!< The second workspace array.
+  size_t n;                     //!< The size of the system.
+
+  size_t start;                 //!< The first equation of the partition.
+  size_t end;                   //!< The last equation of the partition.
+
+  double* reduced_c;            //!< The reduced lower sub-diagonal.
+  double* reduced_d;            //!< The reduced main diagonal.
+  double* reduced_e;            //!< The reduced upper sub-diagonal.
+  double* reduced_b;            //!< The reduced right-hand side.
+  size_t index;                 //!< The index of the partition.
+
+  int result;                   //!< The result of the elimination.
+} spline_tridiag_partition_t;
+
+/** \brief Solve a tridiagonal system of equations
+  * \param[in] c The lower sub-diagonal c = (c_1, ..., c_M)^T of the
+  *   tridiagonal N x N matrix A, an array of length M = N-1.
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the tridiagonal
+  *   matrix A, an array of length N.
+  * \param[in] e The upper sub-diagonal e = (e_1, ..., e_M)^T of the
+  *   tridiagonal matrix A, an array of length M = N-1.
+  * \param[in,out] b The right-hand side vector b = (b_1, ..., b_N)^T of
+  *   length N. On return, the array will contain the solution vector x.
+  * \param[in,out] w A workspace array of length N.
+  * \param[in] n The size N of the tridiagonal system.
+  * \return The resulting error code.
+  * 
+  * This function solves the tridiagonal system of equations A*x = b by
+  * means of the Thomas algorithm in O(N) computational time. Since the
+  * algorithm does not perform any pivoting, the matrix A should be
+  * diagonally dominant. A zero pivot will be reported as an interpolation
+  * error.
+  */
+int spline_tridiag_solve(
+  const double* c,
+  const double* d,
+  const double* e,
+  double* b,
+  double* w,
+  size_t n);
+
+/** \brief Solve a tridiagonal system of equations using multiple threads
+  * \param[in] c The lower sub-diagonal c = (c_1, ..., c_M)^T of the
+  *   tridiagonal N x N matrix A, an array of length M = N-1.
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the tridiagonal
+  *   matrix A, an array of length N.
+  * \param[in] e The upper sub-diagonal e = (e_1, ..., e_M)^T of the
+  *   tridiagonal matrix A, an array of length M = N-1.
+  * \param[in,out] b The right-hand side vector b = (b_1, ..., b_N)^T of
+  *   length N. On return, the array will contain the solution vector x.
+  * \param[in,out] w A workspace array of length N.
+  * \param[in,out] z A workspace array of length N.
+  * \param[in] n The size N of the tridiagonal system.
+  * \param[in] num_threads The maximum number of threads to be used.
+  * \return The resulting error code.
+  * 
+  * This function solves the tridiagonal system of equations A*x = b by
+  * means of a partition method. The system is split into P contiguous
+  * partitions, one per thread. Each thread eliminates the interior
+  * unknowns of its partition in terms of the partition's first and last
+  * unknown. The 2P boundary unknowns then satisfy a reduced tridiagonal
+  * system which is solved serially, before the threads recover the
+  * interior unknowns by substitution. The computational cost thus amounts
+  * to O(N/P+P) time.
+  * 
+  * The number of partitions is limited by SPLINE_TRIDIAG_MAX_THREADS and
+  * such that no partition holds less than SPLINE_TRIDIAG_MIN_PARTITION_SIZE
+  * equations. If a single partition remains, the function falls back to
+  * spline_tridiag_solve(). As for the serial solver, the matrix A should
+  * be diagonally dominant.
+  */
+int spline_tridiag_solve_parallel(
+  const double* c,
+  const double* d,
+  const double* e,
+  double* b,
+  double* w,
+  double* z,
+  size_t n,
+  size_t num_threads);
+
+/** \brief Factor a tridiagonal system of equations
+  * \param[in] c The lower sub-diagonal c = (c_1, ..., c_M)^T of the
+  *   tridiagonal N x N matrix A, an array of length M = N-1.
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the tridiagonal
+  *   matrix A, an array of length N.
+  * \param[in] e The upper sub-diagonal e = (e_1, ..., e_M)^T of the
+  *   tridiagonal matrix A, an array of length M = N-1.
+  * \param[out] w The array of length N receiving the multipliers of the
+  *   factorization.
+  * \param[out] m The array of length N receiving the reciprocal pivots of
+  *   the factorization.
+  * \param[in] n The size N of the tridiagonal system.
+  * \return The resulting error code.
+  * 
+  * This function performs the elimination pass of the Thomas algorithm on
+  * the matrix A only, such that any number of right-hand sides may
+  * subsequently be solved by spline_tridiag_solve_factor() at the cost of
+  * the substitution passes. A zero pivot will be reported as an
+  * interpolation error.
+  */
+int spline_tridiag_factor(
+  const double* c,
+  const double* d,
+  const double* e,
+  double* w,
+  double* m,
+  size_t n);
+
+/** \brief Solve a factored tridiagonal system of equations for multiple
+  *   right-hand sides
+  * \param[in] c The lower sub-diagonal c = (c_1, ..., c_M)^T of the
+  *   tridiagonal N x N matrix A, an array of length M = N-1.
+  * \param[in] w The multipliers of the factorization of A as computed by
+  *   spline_tridiag_factor().
+  * \param[in] m The reciprocal pivots of the factorization of A as computed
+  *   by spline_tridiag_factor().
+  * \param[in,out] b The right-hand side vectors, each of length N and
+  *   separated by the given stride. On return, the array will contain the
+  *   corresponding solution vectors.
+  * \param[in] n The size N of the tridiagonal system.
+  * \param[in] num_rhs The number of right-hand side vectors.
+  * \param[in] stride The distance between consecutive right-hand side
+  *   vectors in b, which must be at least N.
+  * 
+  * The right-hand sides are substituted simultaneously, such that each
+  * element of the factorization is loaded once for all of them.
+  */
+void spline_tridiag_solve_factor(
+  const double* c,
+  const double* w,
+  const double* m,
+  double* b,
+  size_t n,
+  size_t num_rhs,
+  size_t stride);
+
+/** \brief Solve a symmetric cyclic tridiagonal system of equations
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the symmetric
+  *   cyclic tridiagonal N x N matrix A, an array of length N.
+  * \param[in] e The cyclic sub-diagonals e = (e_1, ..., e_N)^T of the
+  *   symmetric cyclic tridiagonal matrix A, an array of length N with e_N
+  *   representing the corner elements of A.
+  * \param[in,out] b The right-hand side vector b = (b_1, ..., b_N)^T of
+  *   length N. On return, the array will contain the solution vector x.
+  * \param[in,out] w A workspace array of length N.
+  * \param[in,out] z A workspace array of length N.
+  * \param[in] n The size N > 1 of the symmetric cyclic tridiagonal system.
+  * \return The resulting error code.
+  * 
+  * This function solves the symmetric cyclic tridiagonal system of
+  * equations A*x = b in O(N) computational time. The corner elements of A
+  * are treated as a rank-one correction of a tridiagonal matrix, such that
+  * the Sherman-Morrison formula yields the solution from a single
+  * elimination pass of the Thomas algorithm applied to two right-hand sides.
+  */
+int spline_tridiag_solve_symm_cyc(
+  const double* d,
+  const double* e,
+  double* b,
+  double* w,
+  double* z,
+  size_t n);
+
+
+/** \brief Factor a symmetric cyclic tridiagonal system of equations
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the symmetric
+  *   cyclic tridiagonal N x N matrix A, an array of length N.
+  * \param[in] e The cyclic sub-diagonals e = (e_1, ..., e_N)^T of the
+  *   symmetric cyclic tridiagonal matrix A, an array of length N with e_N
+  *   representing the corner elements of A.
+  * \param[out] w The array of length N receiving the multipliers of the
+  *   factorization.
+  * \param[out] m The array of length N receiving the reciprocal pivots of
+  *   the factorization.
+  * \param[out] z The array of length N receiving the scaled correction
+  *   vector of the Sherman-Morrison formula.
+  * \param[in] n The size N > 1 of the symmetric cyclic tridiagonal system.
+  * \return The resulting error code.
+  * 
+  * This function factors the tridiagonal part of A and, since it does not
+  * depend on the right-hand side, resolves the rank-one correction of the
+  * Sherman-Morrison formula. Any number of right-hand sides may then be
+  * solved by spline_tridiag_solve_factor_symm_cyc().
+  */
+int spline_tridiag_factor_symm_cyc(
+  const double* d,
+  const double* e,
+  double* w,
+  double* m,
+  double* z,
+  size_t n);
+
+/** \brief Solve a factored symmetric cyclic tridiagonal system of
+  *   equations for multiple right-hand sides
+  * \param[in] d The main diagonal d = (d_1, ..., d_N)^T of the symmetric
+  *   cyclic tridiagonal N x N matrix A, an array of length N.
+  * \param[in] e The cyclic sub-diagonals e = (e_1, ..., e_N)^T of the
+  *   symmetric cyclic tridiagonal matrix A, an array of length N with e_N
+  *   representing the corner elements of A.
+  * \param[in] w The multipliers of the factorization of A as computed by
+  *   spline_tridiag_factor_symm_cyc().
+  * \param[in] m The reciprocal pivots of the factorization of A as computed
+  *   by spline_tridiag_factor_symm_cyc().
+  * \param[in] z The scaled correction vector as computed by
+  *   spline_tridiag_factor_symm_cyc().
+  * \param[in,out] b The right-hand side vectors, each of length N and
+  *   separated by the given stride. On return, the array will contain the
+  *   corresponding solution vectors.
+  * \param[in] n The size N > 1 of the symmetric cyclic tridiagonal system.
+  * \param[in] num_rhs The number of right-hand side vectors.
+  * \param[in] stride The distance between consecutive right-hand side
+  *   vectors in b, which must be at least N.
+  */
+void spline_tridiag_solve_factor_symm_cyc(
+  const double* d,
+  const double* e,
+  const double* w,
+  const double* m,
+  const double* z,
+  double* b,
+  size_t n,
+  size_t num_rhs,
+  size_t stride);
+
+#endif
@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include "workspace.h"
+
+void spline_workspace_init(spline_workspace_t* workspace) {
+  workspace->c = 0;
+  workspace->d = 0;
+  workspace->e = 0;
+  workspace->b = 0;
+  workspace->w = 0;
+  workspace->z = 0;
+  workspace->m = 0;
+  
+  workspace->size = 0;
+  workspace->num_threads = 1;
+}
+
+void spline_workspace_destroy(spline_workspace_t* workspace) {
+  if (workspace->c)
+    free(workspace->c);
+  
+  spline_workspace_init(workspace);
+}
+
+size_t spline_workspace_reserve(spline_workspace_t* workspace, size_t size) {
+  double* c;
+  
+  if (size > workspace->size) {
+    if (size < 2*workspace->size)
+      size = 2*workspace->size;
+    
+    if (size > SIZE_MAX/(7*sizeof(double)))
+      return workspace->size;
+    c = malloc(7*size*sizeof(double));
+    if (!c)
+      return workspace->size;
+    
+    if (workspace->c)
+      free(workspace->c);
+    
+    workspace->c = c;
+    workspace->d = &workspace->c[size];
+    workspace->e = &workspace->d[size];
+    workspace->b = &workspace->e[size];
+    workspace->w = &workspace->b[size];
+    workspace->z = &workspace->w[size];
+    workspace->m = &workspace->z[size];
+    
+    workspace->size = size;
+  }
+  
+  return workspace->size;
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SPLINE_WORKSPACE_H
+#define SPLINE_WORKSPACE_H
+
+/** \file spline/workspace.h
+  * \ingroup spline
+  * \brief Workspace definition for cubic spline interpolation
+  * \author Ralf Kaestner
+  * 
+  * A spline workspace owns the scratch memory required for solving the
+  * systems of equations arising in cubic spline interpolation. It may be
+  * reused across interpolations such as to avoid repeated allocations.
+  */
+
+#include <stdlib.h>
+
+/** \brief Structure defining a spline workspace
+  * 
+  * A spline workspace consists in a set of arrays of equal size, holding
+  * the diagonals and the right-hand side of a tridiagonal system as well
+  * as the scratch memory of the tridiagonal solvers. The system is solved
+  * in place, such that the right-hand side array holds the resulting
+  * derivatives at the spline knots.
+  * 
+  * For large systems, the tridiagonal solvers may partition the system
+  * among multiple threads. The number of threads defaults to one and may
+  * be raised by modifying the workspace directly.
+  */
+typedef struct spline_workspace_t {
+  double* c;                   //!< The lower sub-diagonal of the system.
+  double* d;                   //!< The main diagonal of the system.
+  double* e;                   //!< The upper sub-diagonal of the system.
+  double* b;                   //!< The right-hand side and the solution.
+  double* w;                   //!< The scratch memory of the solvers.
+  double* z;                   //!< The scratch memory of the cyclic solver.
+  double* m;                   //!< The reciprocal pivots of a factored system.
+
+  size_t size;                 //!< The allocated size of the arrays.
+  size_t num_threads;          //!< The number of threads of the solvers.
+} spline_workspace_t;
+
+/** \brief Initialize an empty spline workspace
+  * \param[in] workspace The spline workspace to be initialized.
+  */
+void spline_workspace_init(
+  spline_workspace_t* workspace);
+
+/** \brief Destroy a spline workspace
+  * \param[in] workspace The spline workspace to be destroyed.
+  */
+void spline_workspace_destroy(
+  spline_workspace_t* workspace);
+
+/** \brief Reserve memory in a spline workspace
+  * \param[in] workspace The spline workspace to reserve the memory in.
+  * \param[in] size The requested size of the workspace arrays.
+  * \return The allocated size of the workspace arrays.
+  * 
+  * If the workspace arrays are smaller than requested, they will be
+  * re-allocated to at least twice their previous size. The workspace
+  * never shrinks, such that repeated interpolations of similar size
+  * perform no allocations. Note that the content of the workspace arrays
+  * is not preserved during re-allocation. If the re-allocation fails, the
+  * previous arrays are kept and their size is returned, such that callers
+  * must compare the result against the requested size.
+  */
+size_t spline_workspace_reserve(
+  spline_workspace_t* workspace,
+  size_t size);
+
+#endif
@@ -298,6 +298,78 @@ size_t string_vscanf(const char* string, const char* format, va_list vargs) {
     return 0;
 }
 
+size_t string_parse_float(const char* string, double* value) {
+  static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22};
+  const char* start = string;
+  const char* number;
+  unsigned long long mantissa = 0;
+  int num_digits = 0, exponent = 0, negative = 0, valid = 0;
+  
+  while ((*string == ' ') || (*string == '\t'))
+    ++string;
+  number = string;
+  
+  if ((*string == '-') || (*string == '+'))
+    negative = (*string++ == '-');
+  
+  for ( ; *string == '0'; ++string)
+    valid = 1;
+  for ( ; (*string >= '0') && (*string <= '9'); ++string, ++num_digits)
+    mantissa = 10*mantissa+(*string-'0');
+  
+  if (*string == '.') {
+    ++string;
+    if (!num_digits)
+      for ( ; *string == '0'; ++string, --exponent)
+        valid = 1;
+    for ( ; (*string >= '0') && (*string <= '9'); ++string, ++num_digits) {
+      mantissa = 10*mantissa+(*string-'0');
+      --exponent;
+    }
+  }
+  
+  if ((valid || num_digits) && (*string != 'x') && (*string != 'X')) {
+    if ((*string == 'e') || (*string == 'E')) {
+      const char* exponent_string = string+1;
+      int exponent_negative = 0, exponent_value = 0;
+      
+      if ((*exponent_string == '-') || (*exponent_string == '+'))
+        exponent_negative = (*exponent_string++ == '-');
+      if ((*exponent_string >= '0') && (*exponent_string <= '9')) {
+        for ( ; (*exponent_string >= '0') && (*exponent_string <= '9');
+            ++exponent_string)
+          if (exponent_value < 10000)
+            exponent_value = 10*exponent_value+(*exponent_string-'0');
+        
+        exponent += exponent_negative ? -exponent_value : exponent_value;
+        string = exponent_string;
+      }
+    }
+    
+    if (!num_digits || ((num_digits <= 15) && (exponent >= -22) &&
+        (exponent <= 22))) {
+      if (!num_digits)
+        *value = 0.0;
+      else if (exponent < 0)
+        *value = mantissa/powers[-exponent];
+      else
+        *value = mantissa*powers[exponent];
+      
+      if (negative)
+        *value = -*value;
+      
+      return string-start;
+    }
+  }
+  
+  char* end;
+  *value = strtod(number, &end);
+  
+  return (end > number) ? end-start : 0;
+}
+
 size_t string_printf(char** string, const char* format, ...) {
   va_list vargs;
   
@@ -279,6 +279,25 @@ size_t string_vscanf(
   const char* format,
   va_list vargs);
 
+/** \brief Parse a floating point number from string
+  * \param[in] string The string to parse the floating point number from.
+  * \param[out] value The parsed floating point number.
+  * \return The number of characters consumed from the string, including
+  *   any leading blanks, or zero if the string does not start with a
+  *   floating point number.
+  * 
+  * This function skips leading blanks and parses a decimal floating point
+  * number from the remaining string. Unlike string_scanf(), it does not
+  * interpret a format string. Numbers with at most 15 significant digits
+  * and a decimal exponent of at most 22 in magnitude are converted by
+  * a single, correctly rounded floating point operation. Any other input
+  * is delegated to the standard library conversion, such that the result
+  * is always identical to that of strtod().
+  */
+size_t string_parse_float(
+  const char* string,
+  double* value);
+
 /** \brief Print formatted output to string
   * \param[in,out] string The string to receive the formatted output.
   * \param[in] format A string defining the expected format and conversion
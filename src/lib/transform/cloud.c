@@ -0,0 +1,211 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "cloud.h"
+
+void transform_cloud_init(transform_cloud_t* cloud) {
+  cloud->x = 0;
+  cloud->y = 0;
+  cloud->z = 0;
+  
+  cloud->num_points = 0;
+  cloud->capacity = 0;
+}
+
+void transform_cloud_init_points(transform_cloud_t* cloud, const
+    transform_point_t* points, size_t num_points) {
+  size_t i;
+  
+  transform_cloud_init(cloud);
+  transform_cloud_resize(cloud, num_points);
+  
+  for (i = 0; i < cloud->num_points; ++i)
+    transform_cloud_set_point(cloud, i, &points[i]);
+}
+
+void transform_cloud_destroy(transform_cloud_t* cloud) {
+  if (cloud->x) {
+    free(cloud->x);
+    
+    cloud->x = 0;
+    cloud->y = 0;
+    cloud->z = 0;
+    
+    cloud->num_points = 0;
+    cloud->capacity = 0;
+  }
+}
+
+void transform_cloud_resize(transform_cloud_t* cloud, size_t num_points) {
+  if (num_points > cloud->capacity) {
+    size_t capacity = cloud->capacity ? 2*cloud->capacity :
+      TRANSFORM_CLOUD_ALIGNMENT/sizeof(double);
+    void* data = 0;
+    double* x;
+    double* y;
+    double* z;
+    
+    while (capacity < num_points)
+      capacity <<= 1;
+    if (posix_memalign(&data, TRANSFORM_CLOUD_ALIGNMENT,
+        3*capacity*sizeof(double)))
+      return;
+    
+    x = data;
+    y = &x[capacity];
+    z = &y[capacity];
+    
+    if (cloud->num_points) {
+      memcpy(x, cloud->x, cloud->num_points*sizeof(double));
+      memcpy(y, cloud->y, cloud->num_points*sizeof(double));
+      memcpy(z, cloud->z, cloud->num_points*sizeof(double));
+    }
+    if (cloud->x)
+      free(cloud->x);
+    
+    cloud->x = x;
+    cloud->y = y;
+    cloud->z = z;
+    cloud->capacity = capacity;
+  }
+  
+  cloud->num_points = num_points;
+}
+
+void transform_cloud_set_point(transform_cloud_t* cloud, size_t index,
+    const transform_point_t* point) {
+  cloud->x[index] = point->x;
+  cloud->y[index] = point->y;
+  cloud->z[index] = point->z;
+}
+
+void transform_cloud_get_point(const transform_cloud_t* cloud, size_t index,
+    transform_point_t* point) {
+  point->x = cloud->x[index];
+  point->y = cloud->y[index];
+  point->z = cloud->z[index];
+}
+
+void transform_cloud_print(FILE* stream, const transform_cloud_t* cloud) {
+  size_t i;
+  
+  for (i = 0; i < cloud->num_points; ++i)
+    fprintf(stream, "%10lg %10lg %10lg\n",
+      cloud->x[i],
+      cloud->y[i],
+      cloud->z[i]);
+}
+
+void transform_cloud_float_init(transform_cloud_float_t* cloud) {
+  cloud->x = 0;
+  cloud->y = 0;
+  cloud->z = 0;
+  
+  cloud->num_points = 0;
+  cloud->capacity = 0;
+}
+
+void transform_cloud_float_init_points(transform_cloud_float_t* cloud, const
+    transform_point_t* points, size_t num_points) {
+  size_t i;
+  
+  transform_cloud_float_init(cloud);
+  transform_cloud_float_resize(cloud, num_points);
+  
+  for (i = 0; i < cloud->num_points; ++i)
+    transform_cloud_float_set_point(cloud, i, &points[i]);
+}
+
+void transform_cloud_float_destroy(transform_cloud_float_t* cloud) {
+  if (cloud->x) {
+    free(cloud->x);
+    
+    cloud->x = 0;
+    cloud->y = 0;
+    cloud->z = 0;
+    
+    cloud->num_points = 0;
+    cloud->capacity = 0;
+  }
+}
+
+void transform_cloud_float_resize(transform_cloud_float_t* cloud, size_t
+    num_points) {
+  if (num_points > cloud->capacity) {
+    size_t capacity = cloud->capacity ? 2*cloud->capacity :
+      TRANSFORM_CLOUD_ALIGNMENT/sizeof(float);
+    void* data = 0;
+    float* x;
+    float* y;
+    float* z;
+    
+    while (capacity < num_points)
+      capacity <<= 1;
+    if (posix_memalign(&data, TRANSFORM_CLOUD_ALIGNMENT,
+        3*capacity*sizeof(float)))
+      return;
+    
+    x = data;
+    y = &x[capacity];
+    z = &y[capacity];
+    
+    if (cloud->num_points) {
+      memcpy(x, cloud->x, cloud->num_points*sizeof(float));
+      memcpy(y, cloud->y, cloud->num_points*sizeof(float));
+      memcpy(z, cloud->z, cloud->num_points*sizeof(float));
+    }
+    if (cloud->x)
+      free(cloud->x);
+    
+    cloud->x = x;
+    cloud->y = y;
+    cloud->z = z;
+    cloud->capacity = capacity;
+  }
+  
+  cloud->num_points = num_points;
+}
+
+void transform_cloud_float_set_point(transform_cloud_float_t* cloud, size_t
+    index, const transform_point_t* point) {
+  cloud->x[index] = point->x;
+  cloud->y[index] = point->y;
+  cloud->z[index] = point->z;
+}
+
+void transform_cloud_float_get_point(const transform_cloud_float_t* cloud,
+    size_t index, transform_point_t* point) {
+  point->x = cloud->x[index];
+  point->y = cloud->y[index];
+  point->z = cloud->z[index];
+}
+
+void transform_cloud_float_print(FILE* stream, const transform_cloud_float_t*
+    cloud) {
+  size_t i;
+  
+  for (i = 0; i < cloud->num_points; ++i)
+    fprintf(stream, "%10g %10g %10g\n",
+      cloud->x[i],
+      cloud->y[i],
+      cloud->z[i]);
+}
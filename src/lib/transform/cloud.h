@@ -0,0 +1,203 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_CLOUD_H
+#define TRANSFORM_CLOUD_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "transform/point.h"
+
+/** \file transform/cloud.h
+  * \ingroup transform
+  * \brief Point cloud definition for the linear transformation module
+  * \author Ralf Kaestner
+  * 
+  * A point cloud stores the components of a large number of points in
+  * 3-dimensional space as a structure of arrays. This layout allows
+  * transforms to be applied to many points by vectorized kernels. Point
+  * clouds are provided with double and single precision storage.
+  */
+
+/** \brief Predefined alignment of the point cloud components in [byte]
+  * 
+  * The alignment matches TRANSFORM_CACHE_LINE_SIZE, such that partitions
+  * of the parallel transform functions start on a cache line boundary.
+  */
+#define TRANSFORM_CLOUD_ALIGNMENT           64
+
+/** \brief Structure defining a point cloud
+  * 
+  * The x, y, and z-components of the points are stored in separate arrays,
+  * each of which is aligned to TRANSFORM_CLOUD_ALIGNMENT bytes. The arrays
+  * share a single memory block of geometrically growing capacity.
+  */
+typedef struct transform_cloud_t {
+  double* x;                   //!< The x-components of the points.
+  double* y;                   //!< The y-components of the points.
+  double* z;                   //!< The z-components of the points.
+  
+  size_t num_points;           //!< The number of points in the cloud.
+  size_t capacity;             //!< The number of allocated points.
+} transform_cloud_t;
+
+/** \brief Structure defining a single-precision point cloud
+  * 
+  * Apart from its single-precision components, the point cloud is
+  * organized as defined by transform_cloud_t.
+  */
+typedef struct transform_cloud_float_t {
+  float* x;                    //!< The x-components of the points.
+  float* y;                    //!< The y-components of the points.
+  float* z;                    //!< The z-components of the points.
+  
+  size_t num_points;           //!< The number of points in the cloud.
+  size_t capacity;             //!< The number of allocated points.
+} transform_cloud_float_t;
+
+/** \brief Initialize empty point cloud
+  * \param[in] cloud The point cloud to be initialized.
+  */
+void transform_cloud_init(
+  transform_cloud_t* cloud);
+
+/** \brief Initialize point cloud from an array of points
+  * \param[in] cloud The point cloud to be initialized.
+  * \param[in] points The array of points to initialize the cloud from.
+  * \param[in] num_points The number of points in the array.
+  */
+void transform_cloud_init_points(
+  transform_cloud_t* cloud,
+  const transform_point_t* points,
+  size_t num_points);
+
+/** \brief Destroy point cloud
+  * \param[in] cloud The point cloud to be destroyed.
+  */
+void transform_cloud_destroy(
+  transform_cloud_t* cloud);
+
+/** \brief Resize point cloud
+  * \param[in] cloud The point cloud to be resized.
+  * \param[in] num_points The requested number of points of the cloud.
+  * 
+  * If the capacity of the point cloud is smaller than requested, its
+  * components will be re-allocated to at least twice their previous
+  * capacity. The components of retained points remain unchanged, whereas
+  * the components of additional points are undefined. If the allocation
+  * fails, the point cloud remains unchanged.
+  */
+void transform_cloud_resize(
+  transform_cloud_t* cloud,
+  size_t num_points);
+
+/** \brief Set point of the point cloud
+  * \param[in] cloud The point cloud to set the point for.
+  * \param[in] index The index of the point to be set.
+  * \param[in] point The point providing the components to be set.
+  */
+void transform_cloud_set_point(
+  transform_cloud_t* cloud,
+  size_t index,
+  const transform_point_t* point);
+
+/** \brief Retrieve point of the point cloud
+  * \param[in] cloud The point cloud to retrieve the point for.
+  * \param[in] index The index of the point to be retrieved.
+  * \param[out] point The point receiving the retrieved components.
+  */
+void transform_cloud_get_point(
+  const transform_cloud_t* cloud,
+  size_t index,
+  transform_point_t* point);
+
+/** \brief Print point cloud
+  * \param[in] stream The output stream that will be used for printing the
+  *   point cloud.
+  * \param[in] cloud The point cloud that will be printed.
+  */
+void transform_cloud_print(
+  FILE* stream,
+  const transform_cloud_t* cloud);
+
+/** \brief Initialize empty single-precision point cloud
+  * \param[in] cloud The single-precision point cloud to be initialized.
+  */
+void transform_cloud_float_init(
+  transform_cloud_float_t* cloud);
+
+/** \brief Initialize single-precision point cloud from an array of points
+  * \param[in] cloud The single-precision point cloud to be initialized.
+  * \param[in] points The array of points to initialize the cloud from.
+  * \param[in] num_points The number of points in the array.
+  */
+void transform_cloud_float_init_points(
+  transform_cloud_float_t* cloud,
+  const transform_point_t* points,
+  size_t num_points);
+
+/** \brief Destroy single-precision point cloud
+  * \param[in] cloud The single-precision point cloud to be destroyed.
+  */
+void transform_cloud_float_destroy(
+  transform_cloud_float_t* cloud);
+
+/** \brief Resize single-precision point cloud
+  * \param[in] cloud The single-precision point cloud to be resized.
+  * \param[in] num_points The requested number of points of the cloud.
+  * 
+  * The point cloud is resized as described for transform_cloud_resize().
+  */
+void transform_cloud_float_resize(
+  transform_cloud_float_t* cloud,
+  size_t num_points);
+
+/** \brief Set point of the single-precision point cloud
+  * \param[in] cloud The single-precision point cloud to set the point for.
+  * \param[in] index The index of the point to be set.
+  * \param[in] point The point providing the components to be set.
+  */
+void transform_cloud_float_set_point(
+  transform_cloud_float_t* cloud,
+  size_t index,
+  const transform_point_t* point);
+
+/** \brief Retrieve point of the single-precision point cloud
+  * \param[in] cloud The single-precision point cloud to retrieve the point
+  *   for.
+  * \param[in] index The index of the point to be retrieved.
+  * \param[out] point The point receiving the retrieved components.
+  */
+void transform_cloud_float_get_point(
+  const transform_cloud_float_t* cloud,
+  size_t index,
+  transform_point_t* point);
+
+/** \brief Print single-precision point cloud
+  * \param[in] stream The output stream that will be used for printing the
+  *   point cloud.
+  * \param[in] cloud The single-precision point cloud that will be printed.
+  */
+void transform_cloud_float_print(
+  FILE* stream,
+  const transform_cloud_float_t* cloud);
+
+#endif
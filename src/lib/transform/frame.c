@@ -0,0 +1,346 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "frame.h"
+
+#include "string/string.h"
+
+const char* transform_frame_errors[] = {
+  "Success",
+  "Frame name already defined",
+  "Undefined frame",
+  "Frame would become its own ancestor",
+  "Root frame has no parent transform",
+  "Frames belong to different trees",
+};
+
+ssize_t transform_frame_graph_add_frame(transform_frame_graph_t* graph,
+  const char* name, ssize_t parent, transform_t transform);
+void transform_frame_graph_invalidate(transform_frame_graph_t* graph,
+  size_t frame);
+transform_frame_t* transform_frame_graph_update_world(
+  transform_frame_graph_t* graph, size_t frame);
+transform_frame_t* transform_frame_graph_update_world_inverse(
+  transform_frame_graph_t* graph, size_t frame);
+
+void transform_frame_graph_init(transform_frame_graph_t* graph) {
+  graph->frames = 0;
+  graph->num_frames = 0;
+  
+  error_init(&graph->error, transform_frame_errors);
+}
+
+void transform_frame_graph_destroy(transform_frame_graph_t* graph) {
+  size_t i;
+  
+  if (graph->frames) {
+    for (i = 0; i < graph->num_frames; ++i)
+      string_destroy(&graph->frames[i].name);
+    free(graph->frames);
+    
+    graph->frames = 0;
+    graph->num_frames = 0;
+  }
+  
+  error_destroy(&graph->error);
+}
+
+void transform_frame_graph_print(FILE* stream, const transform_frame_graph_t*
+    graph) {
+  size_t i;
+  int j;
+  
+  for (i = 0; i < graph->num_frames; ++i) {
+    const transform_frame_t* frame = &graph->frames[i];
+    
+    fprintf(stream, "%s %s", frame->name, (frame->parent >= 0) ?
+      graph->frames[frame->parent].name : "-");
+    for (j = 0; j < 3; ++j)
+      fprintf(stream, "  %10lg %10lg %10lg %10lg",
+        frame->transform[j][0],
+        frame->transform[j][1],
+        frame->transform[j][2],
+        frame->transform[j][3]);
+    fprintf(stream, "\n");
+  }
+}
+
+ssize_t transform_frame_graph_find(const transform_frame_graph_t* graph,
+    const char* name) {
+  size_t i;
+  
+  for (i = 0; i < graph->num_frames; ++i)
+    if (string_equal(graph->frames[i].name, name))
+      return i;
+  
+  return -TRANSFORM_FRAME_ERROR_UNDEFINED;
+}
+
+ssize_t transform_frame_graph_add_root(transform_frame_graph_t* graph,
+    const char* name) {
+  transform_t identity;
+  
+  error_clear(&graph->error);
+  
+  transform_init_identity(identity);
+  return transform_frame_graph_add_frame(graph, name, -1, identity);
+}
+
+ssize_t transform_frame_graph_add(transform_frame_graph_t* graph, const
+    char* name, const char* parent, transform_t transform) {
+  ssize_t result;
+  
+  error_clear(&graph->error);
+  
+  result = transform_frame_graph_find(graph, parent);
+  if (result < 0) {
+    error_setf(&graph->error, -result, "%s", parent);
+    return result;
+  }
+  
+  return transform_frame_graph_add_frame(graph, name, result, transform);
+}
+
+ssize_t transform_frame_graph_add_pose(transform_frame_graph_t* graph, const
+    char* name, const char* parent, const transform_pose_t* pose) {
+  transform_t transform;
+  
+  transform_init_pose(transform, pose);
+  return transform_frame_graph_add(graph, name, parent, transform);
+}
+
+int transform_frame_graph_set_transform(transform_frame_graph_t* graph,
+    size_t frame, transform_t transform) {
+  error_clear(&graph->error);
+  
+  if (frame >= graph->num_frames)
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_UNDEFINED, "%lu",
+      (unsigned long)frame);
+  else if (graph->frames[frame].parent < 0)
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_ROOT, "%s",
+      graph->frames[frame].name);
+  else {
+    transform_copy(graph->frames[frame].transform, transform);
+    graph->frames[frame].kind = transform_get_kind(transform);
+    
+    transform_frame_graph_invalidate(graph, frame);
+  }
+  
+  return graph->error.code;
+}
+
+int transform_frame_graph_set_pose(transform_frame_graph_t* graph, size_t
+    frame, const transform_pose_t* pose) {
+  transform_t transform;
+  
+  transform_init_pose(transform, pose);
+  return transform_frame_graph_set_transform(graph, frame, transform);
+}
+
+int transform_frame_graph_set_parent(transform_frame_graph_t* graph, size_t
+    frame, size_t parent, transform_t transform) {
+  transform_frame_t* frames = graph->frames;
+  ssize_t i;
+  
+  error_clear(&graph->error);
+  
+  if ((frame >= graph->num_frames) || (parent >= graph->num_frames)) {
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_UNDEFINED, "%lu",
+      (unsigned long)((frame >= graph->num_frames) ? frame : parent));
+    return graph->error.code;
+  }
+  
+  for (i = parent; i >= 0; i = graph->frames[i].parent)
+    if ((size_t)i == frame) {
+      error_setf(&graph->error, TRANSFORM_FRAME_ERROR_CYCLE, "%s -> %s",
+        graph->frames[frame].name, graph->frames[parent].name);
+      return graph->error.code;
+    }
+  
+  if (frames[frame].parent >= 0) {
+    ssize_t* link = &frames[frames[frame].parent].first_child;
+    
+    while (*link != (ssize_t)frame)
+      link = &frames[*link].next_sibling;
+    *link = frames[frame].next_sibling;
+  }
+  
+  frames[frame].parent = parent;
+  frames[frame].next_sibling = frames[parent].first_child;
+  frames[parent].first_child = frame;
+  
+  transform_copy(frames[frame].transform, transform);
+  frames[frame].kind = transform_get_kind(transform);
+  
+  transform_frame_graph_invalidate(graph, frame);
+  
+  return graph->error.code;
+}
+
+int transform_frame_graph_get_transform(transform_frame_graph_t* graph,
+    size_t target, size_t source, transform_t transform) {
+  transform_frame_t* source_frame;
+  transform_frame_t* target_frame;
+  
+  error_clear(&graph->error);
+  
+  if ((target >= graph->num_frames) || (source >= graph->num_frames)) {
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_UNDEFINED, "%lu",
+      (unsigned long)((target >= graph->num_frames) ? target : source));
+    return graph->error.code;
+  }
+  
+  source_frame = transform_frame_graph_update_world(graph, source);
+  target_frame = transform_frame_graph_update_world(graph, target);
+  
+  if (source_frame->root != target_frame->root)
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_DISCONNECTED,
+      "%s -> %s", source_frame->name, target_frame->name);
+  else if (target == source)
+    transform_init_identity(transform);
+  else if (target == target_frame->root)
+    transform_copy(transform, source_frame->world);
+  else {
+    transform_frame_graph_update_world_inverse(graph, target);
+    
+    if (source == source_frame->root)
+      transform_copy(transform, target_frame->world_inverse);
+    else {
+      transform_copy(transform, source_frame->world);
+      transform_multiply_left(transform, target_frame->world_inverse);
+    }
+  }
+  
+  return graph->error.code;
+}
+
+int transform_frame_graph_lookup(transform_frame_graph_t* graph, const
+    char* target, const char* source, transform_t transform) {
+  ssize_t target_frame = transform_frame_graph_find(graph, target);
+  ssize_t source_frame = transform_frame_graph_find(graph, source);
+  
+  if ((target_frame < 0) || (source_frame < 0)) {
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_UNDEFINED, "%s",
+      (target_frame < 0) ? target : source);
+    return graph->error.code;
+  }
+  
+  return transform_frame_graph_get_transform(graph, target_frame,
+    source_frame, transform);
+}
+
+ssize_t transform_frame_graph_add_frame(transform_frame_graph_t* graph,
+    const char* name, ssize_t parent, transform_t transform) {
+  transform_frame_t* frame;
+  size_t index;
+  
+  if (transform_frame_graph_find(graph, name) >= 0) {
+    error_setf(&graph->error, TRANSFORM_FRAME_ERROR_NAME, "%s", name);
+    return -TRANSFORM_FRAME_ERROR_NAME;
+  }
+  
+  graph->frames = realloc(graph->frames, (graph->num_frames+1)*
+    sizeof(transform_frame_t));
+  
+  index = graph->num_frames;
+  frame = &graph->frames[index];
+  
+  string_init_copy(&frame->name, name);
+  
+  frame->parent = parent;
+  frame->first_child = -1;
+  frame->next_sibling = -1;
+  if (parent >= 0) {
+    frame->next_sibling = graph->frames[parent].first_child;
+    graph->frames[parent].first_child = index;
+  }
+  
+  transform_copy(frame->transform, transform);
+  frame->kind = transform_get_kind(transform);
+  
+  frame->root = index;
+  frame->world_valid = 0;
+  frame->world_inverse_valid = 0;
+  
+  ++graph->num_frames;
+  
+  return index;
+}
+
+void transform_frame_graph_invalidate(transform_frame_graph_t* graph,
+    size_t frame) {
+  ssize_t i;
+  
+  if (graph->frames[frame].world_valid) {
+    graph->frames[frame].world_valid = 0;
+    graph->frames[frame].world_inverse_valid = 0;
+    
+    for (i = graph->frames[frame].first_child; i >= 0;
+        i = graph->frames[i].next_sibling)
+      transform_frame_graph_invalidate(graph, i);
+  }
+}
+
+transform_frame_t* transform_frame_graph_update_world(
+    transform_frame_graph_t* graph, size_t frame) {
+  transform_frame_t* world_frame = &graph->frames[frame];
+  
+  if (!world_frame->world_valid) {
+    if (world_frame->parent >= 0) {
+      transform_frame_t* parent = transform_frame_graph_update_world(graph,
+        world_frame->parent);
+      
+      transform_copy(world_frame->world, world_frame->transform);
+      if (parent->parent >= 0)
+        transform_multiply_left(world_frame->world, parent->world);
+      
+      world_frame->root = parent->root;
+      world_frame->world_kind = (parent->world_kind > world_frame->kind) ?
+        parent->world_kind : world_frame->kind;
+    }
+    else {
+      transform_init_identity(world_frame->world);
+      
+      world_frame->root = frame;
+      world_frame->world_kind = transform_kind_rigid;
+    }
+    
+    world_frame->world_valid = 1;
+    world_frame->world_inverse_valid = 0;
+  }
+  
+  return world_frame;
+}
+
+transform_frame_t* transform_frame_graph_update_world_inverse(
+    transform_frame_graph_t* graph, size_t frame) {
+  transform_frame_t* world_frame = transform_frame_graph_update_world(graph,
+    frame);
+  
+  if (!world_frame->world_inverse_valid) {
+    transform_copy(world_frame->world_inverse, world_frame->world);
+    transform_invert_kind(world_frame->world_inverse,
+      world_frame->world_kind);
+    
+    world_frame->world_inverse_valid = 1;
+  }
+  
+  return world_frame;
+}
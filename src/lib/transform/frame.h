@@ -0,0 +1,263 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_FRAME_H
+#define TRANSFORM_FRAME_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "transform/transform.h"
+
+#include "error/error.h"
+
+/** \file transform/frame.h
+  * \ingroup transform
+  * \brief Frame graph definition for the linear transformation module
+  * \author Ralf Kaestner
+  * 
+  * A frame graph relates named coordinate frames by means of the transforms
+  * between each frame and its parent, thus forming a forest of frame trees.
+  * The transform between any two frames of the same tree is composed from
+  * the transforms of each frame relative to the root of its tree. These
+  * composite transforms and their inverses are memoized per frame, such
+  * that repeated lookups require a single matrix product. When the
+  * transform of a frame changes, only the memoized transforms of the
+  * frame's subtree are invalidated.
+  * 
+  * The frame graph functions are not thread-safe, since lookups update
+  * the memoized transforms.
+  */
+
+/** \name Error Codes
+  * \brief Predefined frame graph error codes
+  */
+//@{
+#define TRANSFORM_FRAME_ERROR_NONE            0
+//!< Success
+#define TRANSFORM_FRAME_ERROR_NAME            1
+//!< Frame name already defined
+#define TRANSFORM_FRAME_ERROR_UNDEFINED       2
+//!< Undefined frame
+#define TRANSFORM_FRAME_ERROR_CYCLE           3
+//!< Frame would become its own ancestor
+#define TRANSFORM_FRAME_ERROR_ROOT            4
+//!< Root frame has no parent transform
+#define TRANSFORM_FRAME_ERROR_DISCONNECTED    5
+//!< Frames belong to different trees
+//@}
+
+/** \brief Predefined frame graph error descriptions
+  */
+extern const char* transform_frame_errors[];
+
+/** \brief Structure defining a frame of the frame graph
+  * 
+  * The frame's transform maps coordinates in the frame to coordinates in
+  * its parent frame. Parent, children, and siblings are referred to by
+  * their index in the frame graph, where a negative index indicates
+  * their absence.
+  */
+typedef struct transform_frame_t {
+  char* name;                  //!< The name of the frame.
+  
+  ssize_t parent;              //!< The index of the parent frame.
+  ssize_t first_child;         //!< The index of the first child frame.
+  ssize_t next_sibling;        //!< The index of the next sibling frame.
+  
+  transform_t transform;       //!< The transform from frame to parent.
+  transform_kind_t kind;       //!< The kind of the frame's transform.
+  
+  size_t root;                 //!< The memoized index of the root frame.
+  transform_t world;           //!< The memoized transform from frame to root.
+  transform_t world_inverse;   //!< The memoized transform from root to frame.
+  transform_kind_t world_kind; //!< The kind of the memoized transforms.
+  int world_valid;             //!< True if the memoized transform is valid.
+  int world_inverse_valid;     //!< True if the memoized inverse is valid.
+} transform_frame_t;
+
+/** \brief Structure defining a frame graph
+  */
+typedef struct transform_frame_graph_t {
+  transform_frame_t* frames;   //!< The frames of the graph.
+  size_t num_frames;           //!< The number of frames of the graph.
+  
+  error_t error;               //!< The most recent frame graph error.
+} transform_frame_graph_t;
+
+/** \brief Initialize empty frame graph
+  * \param[in] graph The frame graph to be initialized.
+  */
+void transform_frame_graph_init(
+  transform_frame_graph_t* graph);
+
+/** \brief Destroy frame graph
+  * \param[in] graph The frame graph to be destroyed.
+  */
+void transform_frame_graph_destroy(
+  transform_frame_graph_t* graph);
+
+/** \brief Print frame graph
+  * \param[in] stream The output stream that will be used for printing the
+  *   frame graph.
+  * \param[in] graph The frame graph that will be printed.
+  * 
+  * Each frame is printed on a separate line, followed by the name of its
+  * parent and the upper three rows of its transform.
+  */
+void transform_frame_graph_print(
+  FILE* stream,
+  const transform_frame_graph_t* graph);
+
+/** \brief Find frame by name
+  * \param[in] graph The frame graph to find the frame in.
+  * \param[in] name The name of the frame to be found.
+  * \return The index of the frame or the negative error code if no such
+  *   frame exists.
+  */
+ssize_t transform_frame_graph_find(
+  const transform_frame_graph_t* graph,
+  const char* name);
+
+/** \brief Add root frame
+  * \param[in] graph The frame graph to add the root frame to.
+  * \param[in] name The unique name of the root frame to be added.
+  * \return The index of the added frame or the negative error code.
+  * 
+  * A root frame has no parent and thus starts a new tree of the frame
+  * graph. Indices of frames remain valid until the graph is destroyed.
+  */
+ssize_t transform_frame_graph_add_root(
+  transform_frame_graph_t* graph,
+  const char* name);
+
+/** \brief Add frame
+  * \param[in] graph The frame graph to add the frame to.
+  * \param[in] name The unique name of the frame to be added.
+  * \param[in] parent The name of the frame's existing parent.
+  * \param[in] transform The transform from the frame to its parent.
+  * \return The index of the added frame or the negative error code.
+  */
+ssize_t transform_frame_graph_add(
+  transform_frame_graph_t* graph,
+  const char* name,
+  const char* parent,
+  transform_t transform);
+
+/** \brief Add frame from pose
+  * \param[in] graph The frame graph to add the frame to.
+  * \param[in] name The unique name of the frame to be added.
+  * \param[in] parent The name of the frame's existing parent.
+  * \param[in] pose The pose of the frame relative to its parent.
+  * \return The index of the added frame or the negative error code.
+  */
+ssize_t transform_frame_graph_add_pose(
+  transform_frame_graph_t* graph,
+  const char* name,
+  const char* parent,
+  const transform_pose_t* pose);
+
+/** \brief Set the transform of a frame
+  * \param[in] graph The frame graph containing the frame.
+  * \param[in] frame The index of the frame to set the transform for.
+  * \param[in] transform The new transform from the frame to its parent.
+  * \return The resulting error code.
+  * 
+  * Setting the transform invalidates the memoized transforms of the frame
+  * and its descendants. Since a frame's memoized transform can only be
+  * valid if its parent's is, invalidation stops at frames which are
+  * already invalid, and repeated updates of the same frame between lookups
+  * are constant in cost.
+  */
+int transform_frame_graph_set_transform(
+  transform_frame_graph_t* graph,
+  size_t frame,
+  transform_t transform);
+
+/** \brief Set the pose of a frame
+  * \param[in] graph The frame graph containing the frame.
+  * \param[in] frame The index of the frame to set the pose for.
+  * \param[in] pose The new pose of the frame relative to its parent.
+  * \return The resulting error code.
+  * 
+  * See transform_frame_graph_set_transform() for details.
+  */
+int transform_frame_graph_set_pose(
+  transform_frame_graph_t* graph,
+  size_t frame,
+  const transform_pose_t* pose);
+
+/** \brief Set the parent of a frame
+  * \param[in] graph The frame graph containing the frame.
+  * \param[in] frame The index of the frame to set the parent for.
+  * \param[in] parent The index of the new parent frame, which must not
+  *   be a descendant of the frame.
+  * \param[in] transform The transform from the frame to its new parent.
+  * \return The resulting error code.
+  * 
+  * The frame and its descendants are moved to the new parent's tree,
+  * invalidating their memoized transforms.
+  */
+int transform_frame_graph_set_parent(
+  transform_frame_graph_t* graph,
+  size_t frame,
+  size_t parent,
+  transform_t transform);
+
+/** \brief Retrieve the transform between two frames
+  * \param[in] graph The frame graph containing the frames.
+  * \param[in] target The index of the target frame.
+  * \param[in] source The index of the source frame.
+  * \param[out] transform The transform which maps coordinates in the
+  *   source frame to coordinates in the target frame.
+  * \return The resulting error code.
+  * 
+  * The transform is composed from the memoized transform of the source
+  * frame and the memoized inverse transform of the target frame, which
+  * are recomputed only if invalid. Both frames must belong to the same
+  * tree of the frame graph.
+  */
+int transform_frame_graph_get_transform(
+  transform_frame_graph_t* graph,
+  size_t target,
+  size_t source,
+  transform_t transform);
+
+/** \brief Look up the transform between two named frames
+  * \param[in] graph The frame graph containing the frames.
+  * \param[in] target The name of the target frame.
+  * \param[in] source The name of the source frame.
+  * \param[out] transform The transform which maps coordinates in the
+  *   source frame to coordinates in the target frame.
+  * \return The resulting error code.
+  * 
+  * This function finds the frames by name and calls
+  * transform_frame_graph_get_transform(). Frequent lookups should prefer
+  * the latter with frame indices obtained once through
+  * transform_frame_graph_find().
+  */
+int transform_frame_graph_lookup(
+  transform_frame_graph_t* graph,
+  const char* target,
+  const char* source,
+  transform_t transform);
+
+#endif
@@ -0,0 +1,41 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_KIND_H
+#define TRANSFORM_KIND_H
+
+/** \file transform/kind.h
+  * \ingroup transform
+  * \brief Definition of the transform kind
+  * \author Ralf Kaestner
+  * 
+  * The transform kind classifies a transformation matrix by its structure,
+  * which determines the cost of operations such as inversion.
+  */
+
+/** \brief Transform kind
+  */
+typedef enum {
+  transform_kind_rigid,           //!< Rotation and translation.
+  transform_kind_affine,          //!< Linear mapping and translation.
+  transform_kind_general,         //!< General projective transform.
+} transform_kind_t;
+
+#endif
@@ -0,0 +1,234 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <math.h>
+
+#include "rigid.h"
+
+void transform_rigid_rotate(const transform_rigid_t* rigid, double* v);
+
+void transform_rigid_init_identity(transform_rigid_t* rigid) {
+  rigid->q_w = 1.0;
+  rigid->q_x = 0.0;
+  rigid->q_y = 0.0;
+  rigid->q_z = 0.0;
+  
+  rigid->t_x = 0.0;
+  rigid->t_y = 0.0;
+  rigid->t_z = 0.0;
+}
+
+void transform_rigid_init_pose(transform_rigid_t* rigid, const
+    transform_pose_t* pose) {
+  double c_y = cos(0.5*pose->yaw), s_y = sin(0.5*pose->yaw);
+  double c_p = cos(0.5*pose->pitch), s_p = sin(0.5*pose->pitch);
+  double c_r = cos(0.5*pose->roll), s_r = sin(0.5*pose->roll);
+  
+  rigid->q_w = c_r*c_p*c_y+s_r*s_p*s_y;
+  rigid->q_x = s_r*c_p*c_y-c_r*s_p*s_y;
+  rigid->q_y = c_r*s_p*c_y+s_r*c_p*s_y;
+  rigid->q_z = c_r*c_p*s_y-s_r*s_p*c_y;
+  
+  rigid->t_x = pose->x;
+  rigid->t_y = pose->y;
+  rigid->t_z = pose->z;
+}
+
+void transform_rigid_init_transform(transform_rigid_t* rigid, transform_t
+    transform) {
+  double trace = transform[0][0]+transform[1][1]+transform[2][2];
+  double s;
+  
+  if (trace > 0.0) {
+    s = 0.5/sqrt(trace+1.0);
+    rigid->q_w = 0.25/s;
+    rigid->q_x = (transform[2][1]-transform[1][2])*s;
+    rigid->q_y = (transform[0][2]-transform[2][0])*s;
+    rigid->q_z = (transform[1][0]-transform[0][1])*s;
+  }
+  else if ((transform[0][0] > transform[1][1]) &&
+      (transform[0][0] > transform[2][2])) {
+    s = 2.0*sqrt(1.0+transform[0][0]-transform[1][1]-transform[2][2]);
+    rigid->q_w = (transform[2][1]-transform[1][2])/s;
+    rigid->q_x = 0.25*s;
+    rigid->q_y = (transform[0][1]+transform[1][0])/s;
+    rigid->q_z = (transform[0][2]+transform[2][0])/s;
+  }
+  else if (transform[1][1] > transform[2][2]) {
+    s = 2.0*sqrt(1.0+transform[1][1]-transform[0][0]-transform[2][2]);
+    rigid->q_w = (transform[0][2]-transform[2][0])/s;
+    rigid->q_x = (transform[0][1]+transform[1][0])/s;
+    rigid->q_y = 0.25*s;
+    rigid->q_z = (transform[1][2]+transform[2][1])/s;
+  }
+  else {
+    s = 2.0*sqrt(1.0+transform[2][2]-transform[0][0]-transform[1][1]);
+    rigid->q_w = (transform[1][0]-transform[0][1])/s;
+    rigid->q_x = (transform[0][2]+transform[2][0])/s;
+    rigid->q_y = (transform[1][2]+transform[2][1])/s;
+    rigid->q_z = 0.25*s;
+  }
+  
+  rigid->t_x = transform[0][3];
+  rigid->t_y = transform[1][3];
+  rigid->t_z = transform[2][3];
+}
+
+void transform_rigid_copy(transform_rigid_t* dst, const transform_rigid_t*
+    src) {
+  dst->q_w = src->q_w;
+  dst->q_x = src->q_x;
+  dst->q_y = src->q_y;
+  dst->q_z = src->q_z;
+  
+  dst->t_x = src->t_x;
+  dst->t_y = src->t_y;
+  dst->t_z = src->t_z;
+}
+
+void transform_rigid_print(FILE* stream, const transform_rigid_t* rigid) {
+  fprintf(stream, "%10lg %10lg %10lg %10lg  %10lg %10lg %10lg",
+    rigid->q_w,
+    rigid->q_x,
+    rigid->q_y,
+    rigid->q_z,
+    rigid->t_x,
+    rigid->t_y,
+    rigid->t_z);
+}
+
+void transform_rigid_get_pose(const transform_rigid_t* rigid,
+    transform_pose_t* pose) {
+  double w = rigid->q_w, x = rigid->q_x, y = rigid->q_y, z = rigid->q_z;
+  double s_p = 2.0*(w*y-z*x);
+  
+  pose->x = rigid->t_x;
+  pose->y = rigid->t_y;
+  pose->z = rigid->t_z;
+  
+  pose->yaw = atan2(2.0*(w*z+x*y), 1.0-2.0*(y*y+z*z));
+  pose->pitch = (s_p >= 1.0) ? M_PI_2 : (s_p <= -1.0) ? -M_PI_2 : asin(s_p);
+  pose->roll = atan2(2.0*(w*x+y*z), 1.0-2.0*(x*x+y*y));
+}
+
+void transform_rigid_get_transform(const transform_rigid_t* rigid,
+    transform_t transform) {
+  double w = rigid->q_w, x = rigid->q_x, y = rigid->q_y, z = rigid->q_z;
+  
+  transform[0][0] = 1.0-2.0*(y*y+z*z);
+  transform[0][1] = 2.0*(x*y-w*z);
+  transform[0][2] = 2.0*(x*z+w*y);
+  transform[0][3] = rigid->t_x;
+  
+  transform[1][0] = 2.0*(x*y+w*z);
+  transform[1][1] = 1.0-2.0*(x*x+z*z);
+  transform[1][2] = 2.0*(y*z-w*x);
+  transform[1][3] = rigid->t_y;
+  
+  transform[2][0] = 2.0*(x*z-w*y);
+  transform[2][1] = 2.0*(y*z+w*x);
+  transform[2][2] = 1.0-2.0*(x*x+y*y);
+  transform[2][3] = rigid->t_z;
+  
+  transform[3][0] = 0.0;
+  transform[3][1] = 0.0;
+  transform[3][2] = 0.0;
+  transform[3][3] = 1.0;
+}
+
+void transform_rigid_multiply_left(transform_rigid_t* right, const
+    transform_rigid_t* left) {
+  double w = left->q_w*right->q_w-left->q_x*right->q_x-
+    left->q_y*right->q_y-left->q_z*right->q_z;
+  double x = left->q_w*right->q_x+left->q_x*right->q_w+
+    left->q_y*right->q_z-left->q_z*right->q_y;
+  double y = left->q_w*right->q_y-left->q_x*right->q_z+
+    left->q_y*right->q_w+left->q_z*right->q_x;
+  double z = left->q_w*right->q_z+left->q_x*right->q_y-
+    left->q_y*right->q_x+left->q_z*right->q_w;
+  double t[3] = {right->t_x, right->t_y, right->t_z};
+  double n = 1.0/sqrt(w*w+x*x+y*y+z*z);
+  
+  transform_rigid_rotate(left, t);
+  
+  right->q_w = w*n;
+  right->q_x = x*n;
+  right->q_y = y*n;
+  right->q_z = z*n;
+  
+  right->t_x = t[0]+left->t_x;
+  right->t_y = t[1]+left->t_y;
+  right->t_z = t[2]+left->t_z;
+}
+
+void transform_rigid_invert(transform_rigid_t* rigid) {
+  double t[3] = {-rigid->t_x, -rigid->t_y, -rigid->t_z};
+  
+  rigid->q_x = -rigid->q_x;
+  rigid->q_y = -rigid->q_y;
+  rigid->q_z = -rigid->q_z;
+  
+  transform_rigid_rotate(rigid, t);
+  
+  rigid->t_x = t[0];
+  rigid->t_y = t[1];
+  rigid->t_z = t[2];
+}
+
+void transform_rigid_point(const transform_rigid_t* rigid,
+    transform_point_t* point) {
+  double v[3] = {point->x, point->y, point->z};
+  
+  transform_rigid_rotate(rigid, v);
+  
+  point->x = v[0]+rigid->t_x;
+  point->y = v[1]+rigid->t_y;
+  point->z = v[2]+rigid->t_z;
+}
+
+void transform_rigid_points(const transform_rigid_t* rigid,
+    transform_point_t* points, size_t num_points) {
+  transform_t transform;
+  size_t i;
+  
+  transform_rigid_get_transform(rigid, transform);
+  
+  for (i = 0; i < num_points; ++i) {
+    double x = points[i].x, y = points[i].y, z = points[i].z;
+    
+    points[i].x = transform[0][0]*x+transform[0][1]*y+transform[0][2]*z+
+      transform[0][3];
+    points[i].y = transform[1][0]*x+transform[1][1]*y+transform[1][2]*z+
+      transform[1][3];
+    points[i].z = transform[2][0]*x+transform[2][1]*y+transform[2][2]*z+
+      transform[2][3];
+  }
+}
+
+void transform_rigid_rotate(const transform_rigid_t* rigid, double* v) {
+  double w = rigid->q_w, x = rigid->q_x, y = rigid->q_y, z = rigid->q_z;
+  double t_x = 2.0*(y*v[2]-z*v[1]);
+  double t_y = 2.0*(z*v[0]-x*v[2]);
+  double t_z = 2.0*(x*v[1]-y*v[0]);
+  
+  v[0] += w*t_x+y*t_z-z*t_y;
+  v[1] += w*t_y+z*t_x-x*t_z;
+  v[2] += w*t_z+x*t_y-y*t_x;
+}
@@ -0,0 +1,168 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TRANSFORM_RIGID_H
+#define TRANSFORM_RIGID_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "transform/point.h"
+#include "transform/pose.h"
+#include "transform/transform.h"
+
+/** \file transform/rigid.h
+  * \ingroup transform
+  * \brief Rigid transformation interface
+  * \author Ralf Kaestner
+  * 
+  * The rigid transformation interface provides a compact representation
+  * of transforms consisting in a rotation and a translation. Compared to
+  * the 4x4 matrix representation, it requires less than half the memory
+  * and allows for considerably cheaper chaining and inversion.
+  */
+
+/** \brief Structure defining a rigid transformation
+  * 
+  * A rigid transformation is defined by a unit quaternion (q_w, q_x, q_y,
+  * q_z) representing its rotation and a translation vector (t_x, t_y, t_z)
+  * which is applied after the rotation.
+  */
+typedef struct transform_rigid_t {
+  double q_w;                  //!< The scalar component of the quaternion.
+  double q_x;                  //!< The x-component of the quaternion.
+  double q_y;                  //!< The y-component of the quaternion.
+  double q_z;                  //!< The z-component of the quaternion.
+
+  double t_x;                  //!< The translation along the x-axis.
+  double t_y;                  //!< The translation along the y-axis.
+  double t_z;                  //!< The translation along the z-axis.
+} transform_rigid_t;
+
+/** \brief Initialize identity rigid transform
+  * \param[in] rigid The rigid transform to be initialized to identity.
+  */
+void transform_rigid_init_identity(
+  transform_rigid_t* rigid);
+
+/** \brief Initialize rigid transform from a pose
+  * \param[in] rigid The rigid transform to be initialized.
+  * \param[in] pose The pose to initialize the rigid transform from.
+  * 
+  * The resulting rigid transform is equivalent to the transform
+  * initialized by transform_init_pose().
+  */
+void transform_rigid_init_pose(
+  transform_rigid_t* rigid,
+  const transform_pose_t* pose);
+
+/** \brief Initialize rigid transform from a transform
+  * \param[in] rigid The rigid transform to be initialized.
+  * \param[in] transform The transform to initialize the rigid transform
+  *   from. Its upper-left 3x3 matrix is assumed to be a rotation matrix.
+  * 
+  * The quaternion is extracted from the rotation matrix by choosing the
+  * numerically most stable of four closed-form solutions.
+  */
+void transform_rigid_init_transform(
+  transform_rigid_t* rigid,
+  transform_t transform);
+
+/** \brief Copy rigid transform
+  * \param[in] dst The destination rigid transform to copy to.
+  * \param[in] src The source rigid transform to copy from.
+  */
+void transform_rigid_copy(
+  transform_rigid_t* dst,
+  const transform_rigid_t* src);
+
+/** \brief Print rigid transform
+  * \param[in] stream The output stream that will be used for printing the
+  *   rigid transform.
+  * \param[in] rigid The rigid transform that will be printed.
+  */
+void transform_rigid_print(
+  FILE* stream,
+  const transform_rigid_t* rigid);
+
+/** \brief Convert rigid transform to a pose
+  * \param[in] rigid The rigid transform to be converted.
+  * \param[out] pose The pose receiving the location and orientation
+  *   represented by the rigid transform.
+  */
+void transform_rigid_get_pose(
+  const transform_rigid_t* rigid,
+  transform_pose_t* pose);
+
+/** \brief Convert rigid transform to a transform
+  * \param[in] rigid The rigid transform to be converted.
+  * \param[out] transform The transform receiving the matrix representation
+  *   of the rigid transform.
+  */
+void transform_rigid_get_transform(
+  const transform_rigid_t* rigid,
+  transform_t transform);
+
+/** \brief Left-multiply rigid transform with another rigid transform
+  * \param[in,out] right The rigid transform that will be the right-hand
+  *   factor of the multiplication and hold the result.
+  * \param[in] left The rigid transform that will be the left-hand factor
+  *   of the multiplication.
+  * 
+  * The product requires about 40 multiplications instead of the 64 of
+  * transform_multiply_left(). This includes the normalization of the
+  * resulting quaternion, which prevents the accumulation of rounding errors
+  * in long chains of transforms.
+  */
+void transform_rigid_multiply_left(
+  transform_rigid_t* right,
+  const transform_rigid_t* left);
+
+/** \brief Invert rigid transform
+  * \param[in,out] rigid The rigid transform that will be inverted.
+  * 
+  * The inverse is given by the conjugate quaternion and the translation
+  * rotated by the conjugate quaternion and negated.
+  */
+void transform_rigid_invert(
+  transform_rigid_t* rigid);
+
+/** \brief Transform point by a rigid transform
+  * \param[in] rigid The rigid transform to apply to the point.
+  * \param[in,out] point The point to be transformed.
+  */
+void transform_rigid_point(
+  const transform_rigid_t* rigid,
+  transform_point_t* point);
+
+/** \brief Transform array of points by a rigid transform
+  * \param[in] rigid The rigid transform to apply to the points.
+  * \param[in,out] points The array of points to be transformed.
+  * \param[in] num_points The number of points in the array.
+  * 
+  * The rotation matrix is computed once from the quaternion, such that
+  * each point requires only 9 multiplications.
+  */
+void transform_rigid_points(
+  const transform_rigid_t* rigid,
+  transform_point_t* points,
+  size_t num_points);
+
+#endif
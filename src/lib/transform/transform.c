@@ -20,11 +20,96 @@
 
 #include <math.h>
 
-#include <gsl/gsl_blas.h>
-#include <gsl/gsl_linalg.h>
+#if defined(__AVX__)
+  #include <immintrin.h>
+#elif defined(__SSE2__) && defined(__GNUC__)
+  #include <immintrin.h>
+  #define TRANSFORM_SIMD_AVX_DISPATCH
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
 
 #include "transform.h"
 
+#include "thread/thread.h"
+
+#if defined(__AVX__)
+  #define TRANSFORM_SIMD_WIDTH 4
+  #define transform_simd_t __m256d
+  #define transform_simd_load(a) _mm256_loadu_pd(a)
+  #define transform_simd_store(a, b) _mm256_storeu_pd(a, b)
+  #define transform_simd_set(a) _mm256_set1_pd(a)
+  #define transform_simd_add(a, b) _mm256_add_pd(a, b)
+  #define transform_simd_mul(a, b) _mm256_mul_pd(a, b)
+  
+  #define TRANSFORM_SIMD_FLOAT_WIDTH 8
+  #define transform_simd_float_t __m256
+  #define transform_simd_float_load(a) _mm256_loadu_ps(a)
+  #define transform_simd_float_store(a, b) _mm256_storeu_ps(a, b)
+  #define transform_simd_float_set(a) _mm256_set1_ps(a)
+  #define transform_simd_float_add(a, b) _mm256_add_ps(a, b)
+  #define transform_simd_float_mul(a, b) _mm256_mul_ps(a, b)
+#elif defined(__SSE2__)
+  #define TRANSFORM_SIMD_WIDTH 2
+  #define transform_simd_t __m128d
+  #define transform_simd_load(a) _mm_loadu_pd(a)
+  #define transform_simd_store(a, b) _mm_storeu_pd(a, b)
+  #define transform_simd_set(a) _mm_set1_pd(a)
+  #define transform_simd_add(a, b) _mm_add_pd(a, b)
+  #define transform_simd_mul(a, b) _mm_mul_pd(a, b)
+  
+  #define TRANSFORM_SIMD_FLOAT_WIDTH 4
+  #define transform_simd_float_t __m128
+  #define transform_simd_float_load(a) _mm_loadu_ps(a)
+  #define transform_simd_float_store(a, b) _mm_storeu_ps(a, b)
+  #define transform_simd_float_set(a) _mm_set1_ps(a)
+  #define transform_simd_float_add(a, b) _mm_add_ps(a, b)
+  #define transform_simd_float_mul(a, b) _mm_mul_ps(a, b)
+#endif
+
+/** \brief Structure defining a partition of the parallel transform
+  *   functions
+  * 
+  * A partition refers to a contiguous range of points processed by one
+  * thread of the parallel transform functions. Depending on the function,
+  * either the array of points or the source and destination point clouds
+  * are defined.
+  */
+typedef struct transform_partition_t {
+  double (*transform)[4];       //!< The transform to be applied.
+  
+  transform_point_t* points;    //!< The array of points to be transformed.
+  const transform_cloud_t* src; //!< The source point cloud.
+  transform_cloud_t* dst;       //!< The destination point cloud.
+  const transform_cloud_float_t* src_float; //!< The single-precision source.
+  transform_cloud_float_t* dst_float; //!< The single-precision destination.
+  
+  size_t start;                 //!< The first point of the partition.
+  size_t end;                   //!< The point following the partition.
+} transform_partition_t;
+
+void transform_arrays(transform_t transform, const double* x, const double*
+  y, const double* z, double* x_t, double* y_t, double* z_t, size_t
+  num_points);
+void transform_arrays_float(transform_t transform, const float* x, const
+  float* y, const float* z, float* x_t, float* y_t, float* z_t, size_t
+  num_points);
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+__attribute__((target("avx"))) size_t transform_arrays_avx(transform_t
+  transform, const double* x, const double* y, const double* z, double* x_t,
+  double* y_t, double* z_t, size_t num_points);
+__attribute__((target("avx"))) size_t transform_arrays_float_avx(
+  transform_t transform, const float* x, const float* y, const float* z,
+  float* x_t, float* y_t, float* z_t, size_t num_points);
+#endif
+size_t transform_partition(transform_partition_t* partitions, transform_t
+  transform, size_t num_points, size_t num_threads, size_t alignment);
+void transform_partition_run(transform_partition_t* partitions, size_t
+  num_partitions, void* (*routine)(void*));
+void* transform_partition_points(void* arg);
+void* transform_partition_cloud(void* arg);
+void* transform_partition_cloud_float(void* arg);
+
 void transform_init_identity(transform_t transform) {
   int i, j;
 
@@ -114,26 +199,111 @@ void transform_multiply_left(transform_t right, transform_t left) {
   transform_copy(right, result);
 }
 
+transform_kind_t transform_get_kind(transform_t transform) {
+  int i, j;
+  
+  if ((transform[3][0] != 0.0) || (transform[3][1] != 0.0) ||
+      (transform[3][2] != 0.0) || (transform[3][3] != 1.0))
+    return transform_kind_general;
+  
+  for (i = 0; i < 3; ++i) {
+    for (j = i; j < 3; ++j) {
+      double p = transform[0][i]*transform[0][j]+
+        transform[1][i]*transform[1][j]+transform[2][i]*transform[2][j];
+      
+      if (fabs((i == j) ? p-1.0 : p) > TRANSFORM_RIGID_EPSILON)
+        return transform_kind_affine;
+    }
+  }
+  
+  return transform_kind_rigid;
+}
+
 void transform_invert(transform_t transform) {
-  gsl_matrix* A = gsl_matrix_calloc(4, 4);
-  gsl_matrix* A_inv = gsl_matrix_calloc(4, 4);
-  gsl_permutation* perm = gsl_permutation_alloc(4);
-  int i, j, signum;
+  transform_invert_kind(transform, transform_get_kind(transform));
+}
 
-  for (i = 0; i < 4; ++i)
-    for (j = 0; j < 4; ++j)
-      gsl_matrix_set(A, i, j, transform[i][j]);
-    
-  gsl_linalg_LU_decomp(A, perm, &signum);
-  gsl_linalg_LU_invert(A, perm, A_inv);
+void transform_invert_kind(transform_t transform, transform_kind_t kind) {
+  transform_t result;
+  int i, j;
   
-  for (i = 0; i < 4; ++i)
-    for (j = 0; j < 4; ++j)
-      transform[i][j] = gsl_matrix_get(A_inv, i, j);
+  if (kind == transform_kind_rigid) {
+    for (i = 0; i < 3; ++i)
+      for (j = 0; j < 3; ++j)
+        result[i][j] = transform[j][i];
+  }
+  else if (kind == transform_kind_affine) {
+    double (*a)[4] = transform;
+    
+    result[0][0] = a[1][1]*a[2][2]-a[1][2]*a[2][1];
+    result[0][1] = a[0][2]*a[2][1]-a[0][1]*a[2][2];
+    result[0][2] = a[0][1]*a[1][2]-a[0][2]*a[1][1];
+    result[1][0] = a[1][2]*a[2][0]-a[1][0]*a[2][2];
+    result[1][1] = a[0][0]*a[2][2]-a[0][2]*a[2][0];
+    result[1][2] = a[0][2]*a[1][0]-a[0][0]*a[1][2];
+    result[2][0] = a[1][0]*a[2][1]-a[1][1]*a[2][0];
+    result[2][1] = a[0][1]*a[2][0]-a[0][0]*a[2][1];
+    result[2][2] = a[0][0]*a[1][1]-a[0][1]*a[1][0];
+    
+    double det_inv = 1.0/(a[0][0]*result[0][0]+a[0][1]*result[1][0]+
+      a[0][2]*result[2][0]);
+    for (i = 0; i < 3; ++i)
+      for (j = 0; j < 3; ++j)
+        result[i][j] *= det_inv;
+  }
+  else {
+    double (*a)[4] = transform;
+    
+    double s_0 = a[0][0]*a[1][1]-a[1][0]*a[0][1];
+    double s_1 = a[0][0]*a[1][2]-a[1][0]*a[0][2];
+    double s_2 = a[0][0]*a[1][3]-a[1][0]*a[0][3];
+    double s_3 = a[0][1]*a[1][2]-a[1][1]*a[0][2];
+    double s_4 = a[0][1]*a[1][3]-a[1][1]*a[0][3];
+    double s_5 = a[0][2]*a[1][3]-a[1][2]*a[0][3];
+    
+    double c_5 = a[2][2]*a[3][3]-a[3][2]*a[2][3];
+    double c_4 = a[2][1]*a[3][3]-a[3][1]*a[2][3];
+    double c_3 = a[2][1]*a[3][2]-a[3][1]*a[2][2];
+    double c_2 = a[2][0]*a[3][3]-a[3][0]*a[2][3];
+    double c_1 = a[2][0]*a[3][2]-a[3][0]*a[2][2];
+    double c_0 = a[2][0]*a[3][1]-a[3][0]*a[2][1];
+    
+    double det_inv = 1.0/(s_0*c_5-s_1*c_4+s_2*c_3+s_3*c_2-s_4*c_1+s_5*c_0);
+    
+    result[0][0] = (a[1][1]*c_5-a[1][2]*c_4+a[1][3]*c_3)*det_inv;
+    result[0][1] = (-a[0][1]*c_5+a[0][2]*c_4-a[0][3]*c_3)*det_inv;
+    result[0][2] = (a[3][1]*s_5-a[3][2]*s_4+a[3][3]*s_3)*det_inv;
+    result[0][3] = (-a[2][1]*s_5+a[2][2]*s_4-a[2][3]*s_3)*det_inv;
+    
+    result[1][0] = (-a[1][0]*c_5+a[1][2]*c_2-a[1][3]*c_1)*det_inv;
+    result[1][1] = (a[0][0]*c_5-a[0][2]*c_2+a[0][3]*c_1)*det_inv;
+    result[1][2] = (-a[3][0]*s_5+a[3][2]*s_2-a[3][3]*s_1)*det_inv;
+    result[1][3] = (a[2][0]*s_5-a[2][2]*s_2+a[2][3]*s_1)*det_inv;
     
-  gsl_matrix_free(A);
-  gsl_matrix_free(A_inv);
-  gsl_permutation_free(perm);
+    result[2][0] = (a[1][0]*c_4-a[1][1]*c_2+a[1][3]*c_0)*det_inv;
+    result[2][1] = (-a[0][0]*c_4+a[0][1]*c_2-a[0][3]*c_0)*det_inv;
+    result[2][2] = (a[3][0]*s_4-a[3][1]*s_2+a[3][3]*s_0)*det_inv;
+    result[2][3] = (-a[2][0]*s_4+a[2][1]*s_2-a[2][3]*s_0)*det_inv;
+    
+    result[3][0] = (-a[1][0]*c_3+a[1][1]*c_1-a[1][2]*c_0)*det_inv;
+    result[3][1] = (a[0][0]*c_3-a[0][1]*c_1+a[0][2]*c_0)*det_inv;
+    result[3][2] = (-a[3][0]*s_3+a[3][1]*s_1-a[3][2]*s_0)*det_inv;
+    result[3][3] = (a[2][0]*s_3-a[2][1]*s_1+a[2][2]*s_0)*det_inv;
+    
+    transform_copy(transform, result);
+    return;
+  }
+  
+  for (i = 0; i < 3; ++i)
+    result[i][3] = -(result[i][0]*transform[0][3]+
+      result[i][1]*transform[1][3]+result[i][2]*transform[2][3]);
+  
+  result[3][0] = 0.0;
+  result[3][1] = 0.0;
+  result[3][2] = 0.0;
+  result[3][3] = 1.0;
+  
+  transform_copy(transform, result);
 }
 
 void transform_translate(transform_t transform, double t_x, double t_y,
@@ -185,3 +355,395 @@ void transform_points(transform_t transform, transform_point_t* points,
   for (i = 0; i < num_points; ++i)
     transform_point(transform, &points[i]);
 }
+
+void transform_points_parallel(transform_t transform, transform_point_t*
+    points, size_t num_points, size_t num_threads) {
+  transform_partition_t partitions[TRANSFORM_MAX_THREADS];
+  size_t num_partitions = transform_partition(partitions, transform,
+    num_points, num_threads, TRANSFORM_CACHE_LINE_SIZE);
+  size_t i;
+  
+  if (num_partitions < 2) {
+    transform_points(transform, points, num_points);
+    return;
+  }
+  
+  for (i = 0; i < num_partitions; ++i)
+    partitions[i].points = points;
+  transform_partition_run(partitions, num_partitions,
+    transform_partition_points);
+}
+
+void transform_cloud(transform_t transform, transform_cloud_t* cloud) {
+  transform_arrays(transform, cloud->x, cloud->y, cloud->z, cloud->x,
+    cloud->y, cloud->z, cloud->num_points);
+}
+
+void transform_cloud_to(transform_t transform, const transform_cloud_t* src,
+    transform_cloud_t* dst) {
+  if (dst != src)
+    dst->num_points = 0;
+  transform_cloud_resize(dst, src->num_points);
+  if (dst->num_points == src->num_points)
+    transform_arrays(transform, src->x, src->y, src->z, dst->x, dst->y,
+      dst->z, src->num_points);
+}
+
+void transform_cloud_float(transform_t transform, transform_cloud_float_t*
+    cloud) {
+  transform_arrays_float(transform, cloud->x, cloud->y, cloud->z, cloud->x,
+    cloud->y, cloud->z, cloud->num_points);
+}
+
+void transform_cloud_float_to(transform_t transform, const
+    transform_cloud_float_t* src, transform_cloud_float_t* dst) {
+  if (dst != src)
+    dst->num_points = 0;
+  transform_cloud_float_resize(dst, src->num_points);
+  if (dst->num_points == src->num_points)
+    transform_arrays_float(transform, src->x, src->y, src->z, dst->x,
+      dst->y, dst->z, src->num_points);
+}
+
+void transform_cloud_to_parallel(transform_t transform, const
+    transform_cloud_t* src, transform_cloud_t* dst, size_t num_threads) {
+  transform_partition_t partitions[TRANSFORM_MAX_THREADS];
+  size_t num_partitions = transform_partition(partitions, transform,
+    src->num_points, num_threads, TRANSFORM_CACHE_LINE_SIZE/sizeof(double));
+  size_t i;
+  
+  if (num_partitions < 2) {
+    transform_cloud_to(transform, src, dst);
+    return;
+  }
+  
+  if (dst != src)
+    dst->num_points = 0;
+  transform_cloud_resize(dst, src->num_points);
+  if (dst->num_points != src->num_points)
+    return;
+  
+  for (i = 0; i < num_partitions; ++i) {
+    partitions[i].src = src;
+    partitions[i].dst = dst;
+  }
+  transform_partition_run(partitions, num_partitions,
+    transform_partition_cloud);
+}
+
+void transform_cloud_float_to_parallel(transform_t transform, const
+    transform_cloud_float_t* src, transform_cloud_float_t* dst, size_t
+    num_threads) {
+  transform_partition_t partitions[TRANSFORM_MAX_THREADS];
+  size_t num_partitions = transform_partition(partitions, transform,
+    src->num_points, num_threads, TRANSFORM_CACHE_LINE_SIZE/sizeof(float));
+  size_t i;
+  
+  if (num_partitions < 2) {
+    transform_cloud_float_to(transform, src, dst);
+    return;
+  }
+  
+  if (dst != src)
+    dst->num_points = 0;
+  transform_cloud_float_resize(dst, src->num_points);
+  if (dst->num_points != src->num_points)
+    return;
+  
+  for (i = 0; i < num_partitions; ++i) {
+    partitions[i].src_float = src;
+    partitions[i].dst_float = dst;
+  }
+  transform_partition_run(partitions, num_partitions,
+    transform_partition_cloud_float);
+}
+
+size_t transform_partition(transform_partition_t* partitions, transform_t
+    transform, size_t num_points, size_t num_threads, size_t alignment) {
+  size_t num_partitions = num_points/TRANSFORM_MIN_PARTITION_SIZE;
+  size_t i;
+  
+  if (num_partitions > num_threads)
+    num_partitions = num_threads;
+  if (num_partitions > TRANSFORM_MAX_THREADS)
+    num_partitions = TRANSFORM_MAX_THREADS;
+  
+  for (i = 0; i < num_partitions; ++i) {
+    partitions[i].transform = transform;
+    
+    partitions[i].points = 0;
+    partitions[i].src = 0;
+    partitions[i].dst = 0;
+    partitions[i].src_float = 0;
+    partitions[i].dst_float = 0;
+    
+    partitions[i].start = i ? partitions[i-1].end : 0;
+    partitions[i].end = (i+1 < num_partitions) ?
+      (i+1)*num_points/num_partitions/alignment*alignment : num_points;
+  }
+  
+  return num_partitions;
+}
+
+void transform_partition_run(transform_partition_t* partitions, size_t
+    num_partitions, void* (*routine)(void*)) {
+  thread_t threads[TRANSFORM_MAX_THREADS];
+  int started[TRANSFORM_MAX_THREADS];
+  size_t i;
+  
+  for (i = 1; i < num_partitions; ++i)
+    started[i] = !thread_start(&threads[i], routine, 0, &partitions[i], 0.0);
+  routine(&partitions[0]);
+  
+  for (i = 1; i < num_partitions; ++i) {
+    if (started[i])
+      thread_wait_exit(&threads[i]);
+    else
+      routine(&partitions[i]);
+  }
+}
+
+void* transform_partition_points(void* arg) {
+  transform_partition_t* partition = arg;
+  
+  transform_points(partition->transform, &partition->points[
+    partition->start], partition->end-partition->start);
+  
+  return 0;
+}
+
+void* transform_partition_cloud(void* arg) {
+  transform_partition_t* partition = arg;
+  const transform_cloud_t* src = partition->src;
+  transform_cloud_t* dst = partition->dst;
+  size_t i = partition->start;
+  
+  transform_arrays(partition->transform, &src->x[i], &src->y[i],
+    &src->z[i], &dst->x[i], &dst->y[i], &dst->z[i], partition->end-i);
+  
+  return 0;
+}
+
+void* transform_partition_cloud_float(void* arg) {
+  transform_partition_t* partition = arg;
+  const transform_cloud_float_t* src = partition->src_float;
+  transform_cloud_float_t* dst = partition->dst_float;
+  size_t i = partition->start;
+  
+  transform_arrays_float(partition->transform, &src->x[i], &src->y[i],
+    &src->z[i], &dst->x[i], &dst->y[i], &dst->z[i], partition->end-i);
+  
+  return 0;
+}
+
+void transform_arrays(transform_t transform, const double* x, const double*
+    y, const double* z, double* x_t, double* y_t, double* z_t, size_t
+    num_points) {
+  double r_00 = transform[0][0], r_01 = transform[0][1];
+  double r_02 = transform[0][2], t_0 = transform[0][3];
+  double r_10 = transform[1][0], r_11 = transform[1][1];
+  double r_12 = transform[1][2], t_1 = transform[1][3];
+  double r_20 = transform[2][0], r_21 = transform[2][1];
+  double r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i = 0;
+  
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+  if (__builtin_cpu_supports("avx"))
+    i = transform_arrays_avx(transform, x, y, z, x_t, y_t, z_t, num_points);
+  else {
+#endif
+#ifdef TRANSFORM_SIMD_WIDTH
+  transform_simd_t m_00 = transform_simd_set(r_00);
+  transform_simd_t m_01 = transform_simd_set(r_01);
+  transform_simd_t m_02 = transform_simd_set(r_02);
+  transform_simd_t m_03 = transform_simd_set(t_0);
+  transform_simd_t m_10 = transform_simd_set(r_10);
+  transform_simd_t m_11 = transform_simd_set(r_11);
+  transform_simd_t m_12 = transform_simd_set(r_12);
+  transform_simd_t m_13 = transform_simd_set(t_1);
+  transform_simd_t m_20 = transform_simd_set(r_20);
+  transform_simd_t m_21 = transform_simd_set(r_21);
+  transform_simd_t m_22 = transform_simd_set(r_22);
+  transform_simd_t m_23 = transform_simd_set(t_2);
+  
+  for ( ; i+TRANSFORM_SIMD_WIDTH <= num_points; i += TRANSFORM_SIMD_WIDTH) {
+    transform_simd_t x_i = transform_simd_load(&x[i]);
+    transform_simd_t y_i = transform_simd_load(&y[i]);
+    transform_simd_t z_i = transform_simd_load(&z[i]);
+    transform_simd_t f_i;
+    
+    f_i = transform_simd_add(transform_simd_mul(m_00, x_i),
+      transform_simd_mul(m_01, y_i));
+    f_i = transform_simd_add(f_i, transform_simd_mul(m_02, z_i));
+    transform_simd_store(&x_t[i], transform_simd_add(f_i, m_03));
+    
+    f_i = transform_simd_add(transform_simd_mul(m_10, x_i),
+      transform_simd_mul(m_11, y_i));
+    f_i = transform_simd_add(f_i, transform_simd_mul(m_12, z_i));
+    transform_simd_store(&y_t[i], transform_simd_add(f_i, m_13));
+    
+    f_i = transform_simd_add(transform_simd_mul(m_20, x_i),
+      transform_simd_mul(m_21, y_i));
+    f_i = transform_simd_add(f_i, transform_simd_mul(m_22, z_i));
+    transform_simd_store(&z_t[i], transform_simd_add(f_i, m_23));
+  }
+#endif
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+  }
+#endif
+  
+  for ( ; i < num_points; ++i) {
+    double x_i = x[i], y_i = y[i], z_i = z[i];
+    
+    x_t[i] = r_00*x_i+r_01*y_i+r_02*z_i+t_0;
+    y_t[i] = r_10*x_i+r_11*y_i+r_12*z_i+t_1;
+    z_t[i] = r_20*x_i+r_21*y_i+r_22*z_i+t_2;
+  }
+}
+
+void transform_arrays_float(transform_t transform, const float* x, const
+    float* y, const float* z, float* x_t, float* y_t, float* z_t, size_t
+    num_points) {
+  float r_00 = transform[0][0], r_01 = transform[0][1];
+  float r_02 = transform[0][2], t_0 = transform[0][3];
+  float r_10 = transform[1][0], r_11 = transform[1][1];
+  float r_12 = transform[1][2], t_1 = transform[1][3];
+  float r_20 = transform[2][0], r_21 = transform[2][1];
+  float r_22 = transform[2][2], t_2 = transform[2][3];
+  size_t i = 0;
+  
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+  if (__builtin_cpu_supports("avx"))
+    i = transform_arrays_float_avx(transform, x, y, z, x_t, y_t, z_t,
+      num_points);
+  else {
+#endif
+#ifdef TRANSFORM_SIMD_FLOAT_WIDTH
+  transform_simd_float_t m_00 = transform_simd_float_set(r_00);
+  transform_simd_float_t m_01 = transform_simd_float_set(r_01);
+  transform_simd_float_t m_02 = transform_simd_float_set(r_02);
+  transform_simd_float_t m_03 = transform_simd_float_set(t_0);
+  transform_simd_float_t m_10 = transform_simd_float_set(r_10);
+  transform_simd_float_t m_11 = transform_simd_float_set(r_11);
+  transform_simd_float_t m_12 = transform_simd_float_set(r_12);
+  transform_simd_float_t m_13 = transform_simd_float_set(t_1);
+  transform_simd_float_t m_20 = transform_simd_float_set(r_20);
+  transform_simd_float_t m_21 = transform_simd_float_set(r_21);
+  transform_simd_float_t m_22 = transform_simd_float_set(r_22);
+  transform_simd_float_t m_23 = transform_simd_float_set(t_2);
+  
+  for ( ; i+TRANSFORM_SIMD_FLOAT_WIDTH <= num_points;
+      i += TRANSFORM_SIMD_FLOAT_WIDTH) {
+    transform_simd_float_t x_i = transform_simd_float_load(&x[i]);
+    transform_simd_float_t y_i = transform_simd_float_load(&y[i]);
+    transform_simd_float_t z_i = transform_simd_float_load(&z[i]);
+    transform_simd_float_t f_i;
+    
+    f_i = transform_simd_float_add(transform_simd_float_mul(m_00, x_i),
+      transform_simd_float_mul(m_01, y_i));
+    f_i = transform_simd_float_add(f_i, transform_simd_float_mul(m_02, z_i));
+    transform_simd_float_store(&x_t[i], transform_simd_float_add(f_i, m_03));
+    
+    f_i = transform_simd_float_add(transform_simd_float_mul(m_10, x_i),
+      transform_simd_float_mul(m_11, y_i));
+    f_i = transform_simd_float_add(f_i, transform_simd_float_mul(m_12, z_i));
+    transform_simd_float_store(&y_t[i], transform_simd_float_add(f_i, m_13));
+    
+    f_i = transform_simd_float_add(transform_simd_float_mul(m_20, x_i),
+      transform_simd_float_mul(m_21, y_i));
+    f_i = transform_simd_float_add(f_i, transform_simd_float_mul(m_22, z_i));
+    transform_simd_float_store(&z_t[i], transform_simd_float_add(f_i, m_23));
+  }
+#endif
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+  }
+#endif
+  
+  for ( ; i < num_points; ++i) {
+    float x_i = x[i], y_i = y[i], z_i = z[i];
+    
+    x_t[i] = r_00*x_i+r_01*y_i+r_02*z_i+t_0;
+    y_t[i] = r_10*x_i+r_11*y_i+r_12*z_i+t_1;
+    z_t[i] = r_20*x_i+r_21*y_i+r_22*z_i+t_2;
+  }
+}
+
+#ifdef TRANSFORM_SIMD_AVX_DISPATCH
+__attribute__((target("avx"))) size_t transform_arrays_avx(transform_t
+    transform, const double* x, const double* y, const double* z, double*
+    x_t, double* y_t, double* z_t, size_t num_points) {
+  __m256d m_00 = _mm256_set1_pd(transform[0][0]);
+  __m256d m_01 = _mm256_set1_pd(transform[0][1]);
+  __m256d m_02 = _mm256_set1_pd(transform[0][2]);
+  __m256d m_03 = _mm256_set1_pd(transform[0][3]);
+  __m256d m_10 = _mm256_set1_pd(transform[1][0]);
+  __m256d m_11 = _mm256_set1_pd(transform[1][1]);
+  __m256d m_12 = _mm256_set1_pd(transform[1][2]);
+  __m256d m_13 = _mm256_set1_pd(transform[1][3]);
+  __m256d m_20 = _mm256_set1_pd(transform[2][0]);
+  __m256d m_21 = _mm256_set1_pd(transform[2][1]);
+  __m256d m_22 = _mm256_set1_pd(transform[2][2]);
+  __m256d m_23 = _mm256_set1_pd(transform[2][3]);
+  size_t i = 0;
+  
+  for ( ; i+4 <= num_points; i += 4) {
+    __m256d x_i = _mm256_loadu_pd(&x[i]);
+    __m256d y_i = _mm256_loadu_pd(&y[i]);
+    __m256d z_i = _mm256_loadu_pd(&z[i]);
+    __m256d f_i;
+    
+    f_i = _mm256_add_pd(_mm256_mul_pd(m_00, x_i), _mm256_mul_pd(m_01, y_i));
+    f_i = _mm256_add_pd(f_i, _mm256_mul_pd(m_02, z_i));
+    _mm256_storeu_pd(&x_t[i], _mm256_add_pd(f_i, m_03));
+    
+    f_i = _mm256_add_pd(_mm256_mul_pd(m_10, x_i), _mm256_mul_pd(m_11, y_i));
+    f_i = _mm256_add_pd(f_i, _mm256_mul_pd(m_12, z_i));
+    _mm256_storeu_pd(&y_t[i], _mm256_add_pd(f_i, m_13));
+    
+    f_i = _mm256_add_pd(_mm256_mul_pd(m_20, x_i), _mm256_mul_pd(m_21, y_i));
+    f_i = _mm256_add_pd(f_i, _mm256_mul_pd(m_22, z_i));
+    _mm256_storeu_pd(&z_t[i], _mm256_add_pd(f_i, m_23));
+  }
+  
+  return i;
+}
+
+__attribute__((target("avx"))) size_t transform_arrays_float_avx(
+    transform_t transform, const float* x, const float* y, const float* z,
+    float* x_t, float* y_t, float* z_t, size_t num_points) {
+  __m256 m_00 = _mm256_set1_ps(transform[0][0]);
+  __m256 m_01 = _mm256_set1_ps(transform[0][1]);
+  __m256 m_02 = _mm256_set1_ps(transform[0][2]);
+  __m256 m_03 = _mm256_set1_ps(transform[0][3]);
+  __m256 m_10 = _mm256_set1_ps(transform[1][0]);
+  __m256 m_11 = _mm256_set1_ps(transform[1][1]);
+  __m256 m_12 = _mm256_set1_ps(transform[1][2]);
+  __m256 m_13 = _mm256_set1_ps(transform[1][3]);
+  __m256 m_20 = _mm256_set1_ps(transform[2][0]);
+  __m256 m_21 = _mm256_set1_ps(transform[2][1]);
+  __m256 m_22 = _mm256_set1_ps(transform[2][2]);
+  __m256 m_23 = _mm256_set1_ps(transform[2][3]);
+  size_t i = 0;
+  
+  for ( ; i+8 <= num_points; i += 8) {
+    __m256 x_i = _mm256_loadu_ps(&x[i]);
+    __m256 y_i = _mm256_loadu_ps(&y[i]);
+    __m256 z_i = _mm256_loadu_ps(&z[i]);
+    __m256 f_i;
+    
+    f_i = _mm256_add_ps(_mm256_mul_ps(m_00, x_i), _mm256_mul_ps(m_01, y_i));
+    f_i = _mm256_add_ps(f_i, _mm256_mul_ps(m_02, z_i));
+    _mm256_storeu_ps(&x_t[i], _mm256_add_ps(f_i, m_03));
+    
+    f_i = _mm256_add_ps(_mm256_mul_ps(m_10, x_i), _mm256_mul_ps(m_11, y_i));
+    f_i = _mm256_add_ps(f_i, _mm256_mul_ps(m_12, z_i));
+    _mm256_storeu_ps(&y_t[i], _mm256_add_ps(f_i, m_13));
+    
+    f_i = _mm256_add_ps(_mm256_mul_ps(m_20, x_i), _mm256_mul_ps(m_21, y_i));
+    f_i = _mm256_add_ps(f_i, _mm256_mul_ps(m_22, z_i));
+    _mm256_storeu_ps(&z_t[i], _mm256_add_ps(f_i, m_23));
+  }
+  
+  return i;
+}
+#endif
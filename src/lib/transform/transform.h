@@ -35,8 +35,8 @@
   * 
   * The linear transformation interface facilitates the construction and
   * chaining of matrix representations for translational, rotational, and
-  * scaling transforms as well as their application to points in 3-dimensional
-  * space.
+  * scaling transforms as well as their application to points and point
+  * clouds in 3-dimensional space.
   */
 
 #include <stdlib.h>
@@ -44,6 +44,31 @@
 
 #include "transform/point.h"
 #include "transform/pose.h"
+#include "transform/cloud.h"
+#include "transform/kind.h"
+
+/** \brief The maximum number of threads of the parallel transform
+  *   functions
+  */
+#define TRANSFORM_MAX_THREADS                 64
+
+/** \brief The minimum number of points per partition of the parallel
+  *   transform functions
+  * 
+  * Smaller arrays of points are transformed serially, since the cost of
+  * starting the threads would exceed the gain from partitioning.
+  */
+#define TRANSFORM_MIN_PARTITION_SIZE          32768
+
+/** \brief The cache line size in [byte] assumed for aligning the partitions
+  *   of the parallel transform functions
+  */
+#define TRANSFORM_CACHE_LINE_SIZE             64
+
+/** \brief The maximum deviation of the rotational part of a rigid
+  *   transform from orthonormality
+  */
+#define TRANSFORM_RIGID_EPSILON               1e-12
 
 /** \brief Structure defining a transformation
   * 
@@ -128,12 +153,43 @@ void transform_multiply_left(
   transform_t right,
   transform_t left);
 
+/** \brief Retrieve the kind of a transform
+  * \param[in] transform The transform to retrieve the kind for.
+  * \return The kind of the transform.
+  * 
+  * A transform whose last row differs from (0, 0, 0, 1) is general. Else,
+  * the transform is rigid if the columns of its upper-left 3x3 matrix are
+  * orthonormal within TRANSFORM_RIGID_EPSILON, and affine otherwise. The
+  * classification requires 18 multiplications and no allocation.
+  */
+transform_kind_t transform_get_kind(
+  transform_t transform);
+
 /** \brief Invert transform
   * \param[in,out] transform The transform that will be inverted.
+  * 
+  * This function determines the kind of the transform by means of
+  * transform_get_kind() and inverts it by calling transform_invert_kind().
   */
 void transform_invert(
   transform_t transform);
 
+/** \brief Invert transform of a given kind
+  * \param[in,out] transform The transform that will be inverted.
+  * \param[in] kind The kind of the transform, which should be known to the
+  *   caller, e.g., from the transform's construction.
+  * 
+  * The inverse is computed in closed form and without allocation. For a
+  * rigid transform with rotation R and translation t, the inverse is given
+  * by the rotation R^T and the translation -R^T*t. An affine transform is
+  * inverted by the adjugate of its upper-left 3x3 matrix. A general
+  * transform is inverted by the adjugate of the 4x4 matrix. The inverse
+  * of a singular transform is undefined.
+  */
+void transform_invert_kind(
+  transform_t transform,
+  transform_kind_t kind);
+
 /** \brief Apply translation
   * \param[in,out] transform The transform to apply the translation to.
   * \param[in] t_x The translation along the x-axis.
@@ -188,4 +244,124 @@ void transform_points(
   transform_point_t* points,
   size_t num_points);
 
+/** \brief Transform array of points using multiple threads
+  * \param[in] transform The transform to apply to the points.
+  * \param[in,out] points The array of points to be transformed.
+  * \param[in] num_points The number of points in the array.
+  * \param[in] num_threads The maximum number of threads to be used.
+  * 
+  * The array is split into contiguous partitions, each of which is
+  * transformed by transform_points() within its own thread. The partition
+  * boundaries are aligned to cache lines relative to the start of the array,
+  * such that no two threads write to the same cache line.
+  * 
+  * The number of partitions is limited by TRANSFORM_MAX_THREADS and such
+  * that no partition holds less than TRANSFORM_MIN_PARTITION_SIZE points.
+  * For smaller arrays or a single thread, the points are transformed
+  * serially.
+  */
+void transform_points_parallel(
+  transform_t transform,
+  transform_point_t* points,
+  size_t num_points,
+  size_t num_threads);
+
+/** \brief Transform point cloud
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in,out] cloud The point cloud to be transformed.
+  * 
+  * The transform is applied to the point cloud by a vectorized kernel
+  * where supported by the target architecture (AVX or SSE2), processing
+  * the components of 4 or 2 points at once. Unless the library is built
+  * for AVX, the AVX kernel is selected at runtime if the executing
+  * processor supports it. Since the point cloud is streamed through memory
+  * only once, the throughput for large point clouds is bounded by the
+  * memory bandwidth.
+  */
+void transform_cloud(
+  transform_t transform,
+  transform_cloud_t* cloud);
+
+/** \brief Transform point cloud into another point cloud
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in] src The source point cloud to be transformed.
+  * \param[in,out] dst The destination point cloud receiving the transformed
+  *   points. It will be resized to the number of points of the source
+  *   point cloud and may refer to the source point cloud.
+  * 
+  * Like transform_cloud(), this function transforms the point cloud by a
+  * vectorized kernel, but leaves the source point cloud unchanged.
+  */
+void transform_cloud_to(
+  transform_t transform,
+  const transform_cloud_t* src,
+  transform_cloud_t* dst);
+
+/** \brief Transform single-precision point cloud
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in,out] cloud The single-precision point cloud to be transformed.
+  * 
+  * The transform is converted to single precision and applied to the point
+  * cloud by a vectorized kernel where supported by the target architecture
+  * (AVX or SSE), processing the components of 8 or 4 points at once.
+  */
+void transform_cloud_float(
+  transform_t transform,
+  transform_cloud_float_t* cloud);
+
+/** \brief Transform single-precision point cloud into another point cloud
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in] src The source single-precision point cloud to be transformed.
+  * \param[in,out] dst The destination single-precision point cloud
+  *   receiving the transformed points. It will be resized to the number
+  *   of points of the source point cloud and may refer to the source
+  *   point cloud.
+  */
+void transform_cloud_float_to(
+  transform_t transform,
+  const transform_cloud_float_t* src,
+  transform_cloud_float_t* dst);
+
+/** \brief Transform point cloud into another point cloud using multiple
+  *   threads
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in] src The source point cloud to be transformed.
+  * \param[in,out] dst The destination point cloud receiving the transformed
+  *   points. It will be resized to the number of points of the source
+  *   point cloud and may refer to the source point cloud.
+  * \param[in] num_threads The maximum number of threads to be used.
+  * 
+  * The point cloud is partitioned as described for
+  * transform_points_parallel(), and each partition is transformed by the
+  * vectorized kernel of transform_cloud_to(). Unless the destination
+  * refers to the source, its previous points are discarded before it is
+  * resized. Newly allocated memory of the destination is thus first
+  * written by the thread transforming the corresponding partition, which
+  * places it close to that thread on NUMA systems.
+  */
+void transform_cloud_to_parallel(
+  transform_t transform,
+  const transform_cloud_t* src,
+  transform_cloud_t* dst,
+  size_t num_threads);
+
+/** \brief Transform single-precision point cloud into another point cloud
+  *   using multiple threads
+  * \param[in] transform The transform to apply to the point cloud.
+  * \param[in] src The source single-precision point cloud to be transformed.
+  * \param[in,out] dst The destination single-precision point cloud
+  *   receiving the transformed points. It will be resized to the number
+  *   of points of the source point cloud and may refer to the source
+  *   point cloud.
+  * \param[in] num_threads The maximum number of threads to be used.
+  * 
+  * The point cloud is transformed as described for
+  * transform_cloud_to_parallel().
+  */
+void transform_cloud_float_to_parallel(
+  transform_t transform,
+  const transform_cloud_float_t* src,
+  transform_cloud_float_t* dst,
+  size_t num_threads);
+
 #endif
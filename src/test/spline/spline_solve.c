@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2013 by Ralf Kaestner                                   *
+ *   ralf.kaestner@gmail.com                                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+
+#include "spline/spline.h"
+
+#define SPLINE_SOLVE_TOLERANCE                1e-9
+
+int spline_solve_check(spline_t* spline, spline_eval_type_t eval_type,
+    double y, const double* expected, size_t num_expected) {
+  double x[4];
+  size_t i, num_roots = spline_solve(spline, eval_type, y, x, 4);
+  int result = (num_roots == num_expected);
+  
+  for (i = 0; result && (i < num_roots); ++i)
+    result = (fabs(x[i]-expected[i]) < SPLINE_SOLVE_TOLERANCE);
+  
+  if (!result) {
+    fprintf(stderr, "Solving for %lg failed: expected %lu locations, "
+      "found %lu\n", y, (unsigned long)num_expected,
+      (unsigned long)num_roots);
+    for (i = 0; i < num_roots; ++i)
+      fprintf(stderr, "  %lg\n", x[i]);
+  }
+  
+  return result;
+}
+
+int main(int argc, char **argv) {
+  spline_t spline;
+  spline_knot_t knot;
+  int result = 1;
+  
+  /* A single segment of f(x) = (x-2)^3-3.5*(x-2) on [0, 4], which has
+   * its local maximum and minimum at 2-sqrt(7/6) and 2+sqrt(7/6) inside
+   * the segment. */
+  double roots[] = {2.0-sqrt(3.5), 2.0, 2.0+sqrt(3.5)};
+  double extrema[] = {2.0-sqrt(3.5/3.0), 2.0+sqrt(3.5/3.0)};
+  double inflection[] = {2.0};
+  
+  spline_init(&spline);
+  
+  spline_knot_init(&knot, 0.0, -1.0, -12.0);
+  spline_add_knot(&spline, &knot);
+  spline_knot_init(&knot, 4.0, 1.0, 12.0);
+  spline_add_knot(&spline, &knot);
+  
+  result &= spline_solve_check(&spline, spline_eval_type_base_function,
+    0.0, roots, sizeof(roots)/sizeof(double));
+  result &= spline_solve_check(&spline, spline_eval_type_first_derivative,
+    0.0, extrema, sizeof(extrema)/sizeof(double));
+  result &= spline_solve_check(&spline, spline_eval_type_second_derivative,
+    0.0, inflection, sizeof(inflection)/sizeof(double));
+  
+  /* Neither the local maximum nor the local minimum are attained at the
+   * bounds of the segment, so values beyond them have no solution. */
+  result &= spline_solve_check(&spline, spline_eval_type_base_function,
+    2.6, 0, 0);
+  result &= spline_solve_check(&spline, spline_eval_type_base_function,
+    -2.6, 0, 0);
+  
+  spline_destroy(&spline);
+  
+  return result ? 0 : 1;
+}